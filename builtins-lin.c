@@ -0,0 +1,425 @@
+/******************************************************************************
+ * Mini Shell in Linux - internal commands implementation
+ *****************************************************************************/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <unistd.h>
+
+#include "builtins.h"
+#include "hash.h"
+#include "minternals.h"
+#include "utils.h"
+
+/* Size of the dispatch table (a power of 2, at least twice the commands) */
+#define BUILTIN_SLOTS 16
+
+#define HEX_DIGITS "0123456789abcdefABCDEF"
+#define UNICODE_MAX 0x10ffff
+
+/**
+ * Output of a command, collected so that it is written with one write(2).
+ */
+typedef struct {
+  char *data;
+  size_t length;
+  size_t size;
+} output_t;
+
+
+
+/* Declarations */
+static int shell_exit (char **argv);
+static int shell_cd   (char **argv);
+static int shell_true (char **argv);
+static int shell_false(char **argv);
+static int shell_echo (char **argv);
+static int shell_pwd  (char **argv);
+static int shell_hash (char **argv);
+
+static int  find_builtin(const char *name);
+static void out_append  (output_t *out, const char *data, size_t length);
+static void out_char    (output_t *out, char c);
+static int  out_flush   (output_t *out, const char *name);
+static bool echo_escape (output_t *out, const char **s);
+static bool utf8_locale ();
+
+static const struct {
+  const char *name;
+  builtin_t run;
+  bool pure;  /* Leaves the shell as it is */
+} builtins[] = {
+  { "exit",  shell_exit,  false },
+  { "quit",  shell_exit,  false },
+  { "cd",    shell_cd,    false },
+  { "true",  shell_true,  true  },
+  { "false", shell_false, true  },
+  { "echo",  shell_echo,  true  },
+  { "pwd",   shell_pwd,   true  },
+  { "hash",  shell_hash,  false },
+};
+
+/* Open addressing table of indexes in builtins, plus one (0 is empty) */
+static unsigned char slots[BUILTIN_SLOTS];
+static bool slots_ready;
+
+
+
+/**
+ * Internal command called name, or NULL if there is none.
+ */
+builtin_t builtin_lookup(const char *name) {
+  int b = find_builtin(name);
+
+  return b >= 0 ? builtins[b].run : NULL;
+}
+
+/**
+ * Check whether the internal command name leaves the shell as it is.
+ */
+bool builtin_pure(const char *name) {
+  int b = find_builtin(name);
+
+  return b >= 0 && builtins[b].pure;
+}
+
+
+
+/**
+ * Index of the internal command name in builtins, or -1.
+ */
+static int find_builtin(const char *name) {
+  unsigned int i;
+
+  if (!slots_ready) {
+    /* First call: fill the table */
+    int n = sizeof(builtins) / sizeof(builtins[0]);
+    int b;
+    for (b = 0; b < n; b++) {
+      i = fnv1a(builtins[b].name, strlen(builtins[b].name));
+      while (slots[i % BUILTIN_SLOTS] != 0) {
+        i++;
+      }
+      slots[i % BUILTIN_SLOTS] = b + 1;
+    }
+    slots_ready = true;
+  }
+
+  for (i = fnv1a(name, strlen(name)); slots[i % BUILTIN_SLOTS] != 0; i++) {
+    int b = slots[i % BUILTIN_SLOTS] - 1;
+    if (strcmp(builtins[b].name, name) == 0) {
+      return b;
+    }
+  }
+
+  return -1;
+}
+
+
+
+/**
+ * Internal exit/quit command; exit n makes n the exit code of the shell.
+ */
+static int shell_exit(char **argv) {
+  if (argv[1] != NULL) {
+    char *end;
+    long code = strtol(argv[1], &end, 10);
+    if (argv[1][0] == 0 || *end != 0) {
+      fprintf(stderr, "%s: %s: numeric argument required\n", argv[0],
+              argv[1]);
+      code = 2;
+    }
+    last_status = code & 0xff;
+  }
+
+  return SHELL_EXIT;
+}
+
+/**
+ * Internal change-directory command; without an argument, go to $HOME.
+ */
+static int shell_cd(char **argv) {
+  const char *dir = argv[1] != NULL ? argv[1] : getenv("HOME");
+
+  if (dir == NULL) {
+    fprintf(stderr, "cd: HOME not set\n");
+    return EXIT_FAILURE;
+  }
+
+  if (chdir(dir) != 0) {
+    perror("Could not change directory");
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+/**
+ * Internal true command.
+ */
+static int shell_true(char **argv) {
+  return EXIT_SUCCESS;
+}
+
+/**
+ * Internal false command.
+ */
+static int shell_false(char **argv) {
+  return EXIT_FAILURE;
+}
+
+/**
+ * Internal echo command, as the one of bash: options -n (no trailing
+ * newline), -e (interpret backslash escapes) and -E (do not), possibly
+ * combined; the first argument that is not an option starts the text.
+ */
+static int shell_echo(char **argv) {
+  output_t out = { NULL, 0, 0 };
+  bool newline = true, escapes = false;
+  int i;
+
+  for (i = 1; argv[i] != NULL && argv[i][0] == '-' && argv[i][1] != 0; i++) {
+    const char *opt = argv[i] + 1;
+    if (strspn(opt, "neE") != strlen(opt)) {
+      break;
+    }
+    for (; *opt != 0; opt++) {
+      if (*opt == 'n') {
+        newline = false;
+      } else {
+        escapes = *opt == 'e';
+      }
+    }
+  }
+
+  for (; argv[i] != NULL; i++) {
+    const char *s = argv[i];
+
+    if (!escapes) {
+      out_append(&out, s, strlen(s));
+    } else {
+      while (*s != 0) {
+        if (*s != '\\') {
+          out_char(&out, *s++);
+        } else if (!echo_escape(&out, &s)) {
+          /* \c: stop, without the newline */
+          return out_flush(&out, argv[0]);
+        }
+      }
+    }
+
+    if (argv[i + 1] != NULL) {
+      out_char(&out, ' ');
+    }
+  }
+
+  if (newline) {
+    out_char(&out, '\n');
+  }
+
+  return out_flush(&out, argv[0]);
+}
+
+/**
+ * Internal pwd command.
+ */
+static int shell_pwd(char **argv) {
+  char *cwd = getcwd(NULL, 0);
+  if (cwd == NULL) {
+    perror("pwd");
+    return EXIT_FAILURE;
+  }
+
+  output_t out = { NULL, 0, 0 };
+  out_append(&out, cwd, strlen(cwd));
+  out_char(&out, '\n');
+  free(cwd);
+
+  return out_flush(&out, argv[0]);
+}
+
+/**
+ * Internal hash command: without arguments, list the remembered executables;
+ * -r forgets them all; names are looked up in PATH again.
+ */
+static int shell_hash(char **argv) {
+  int rc = EXIT_SUCCESS;
+  int i = 1;
+
+  if (argv[1] == NULL) {
+    return hash_print();
+  }
+
+  if (strcmp(argv[1], "-r") == 0) {
+    hash_clear();
+    i++;
+  }
+
+  for (; argv[i] != NULL; i++) {
+    if (strchr(argv[i], '/') == NULL && !hash_remember(argv[i])) {
+      fprintf(stderr, "hash: %s: not found\n", argv[i]);
+      rc = EXIT_FAILURE;
+    }
+  }
+
+  return rc;
+}
+
+
+
+/**
+ * Append length bytes to out.
+ */
+static void out_append(output_t *out, const char *data, size_t length) {
+  if (out->length + length > out->size) {
+    size_t size = out->size == 0 ? 256 : out->size;
+    while (size < out->length + length) {
+      size *= 2;
+    }
+
+    char *grown = realloc(out->data, size);
+    if (grown == NULL) {
+      mfatal(ERR_ALLOCATION);
+    }
+    out->data = grown;
+    out->size = size;
+  }
+
+  memcpy(out->data + out->length, data, length);
+  out->length += length;
+}
+
+/**
+ * Append a character to out.
+ */
+static void out_char(output_t *out, char c) {
+  out_append(out, &c, 1);
+}
+
+/**
+ * Write out to the standard output and release it. Returns the exit code of
+ * the command called name.
+ */
+static int out_flush(output_t *out, const char *name) {
+  size_t done = 0;
+  int rc = EXIT_SUCCESS;
+
+  while (done < out->length) {
+    ssize_t n = write(STDOUT_FILENO, out->data + done, out->length - done);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      fprintf(stderr, "%s: write error: %s\n", name, strerror(errno));
+      rc = EXIT_FAILURE;
+      break;
+    }
+    done += n;
+  }
+
+  free(out->data);
+  return rc;
+}
+
+/**
+ * Interpret the backslash escape at *s (as echo -e in bash) and move *s past
+ * it. Returns false for \c, which ends the output.
+ */
+static bool echo_escape(output_t *out, const char **s) {
+  static const char simple[] = "a\ab\be\033E\033f\fn\nr\rt\tv\v\\\\";
+  const char *p = *s + 1;
+  const char *found;
+  unsigned long value = 0;
+  int digits = 0, max;
+
+  if (*p == 'c') {
+    return false;
+  }
+
+  if (*p == 0) {
+    /* A lone backslash at the end */
+    out_char(out, '\\');
+    *s = p;
+    return true;
+  }
+
+  found = strchr(simple, *p);
+  if (found != NULL && (found - simple) % 2 == 0) {
+    out_char(out, found[1]);
+    *s = p + 1;
+    return true;
+  }
+
+  if (*p == '0') {
+    /* \0nnn: up to three octal digits */
+    for (p++; digits < 3 && *p >= '0' && *p <= '7'; p++, digits++) {
+      value = value * 8 + (*p - '0');
+    }
+    out_char(out, (char)value);
+    *s = p;
+    return true;
+  }
+
+  if (*p != 'x' && *p != 'u' && *p != 'U') {
+    /* Unknown escapes are printed as they are */
+    out_append(out, *s, 2);
+    *s = p + 1;
+    return true;
+  }
+
+  /* \xHH, \uHHHH, \UHHHHHHHH */
+  max = *p == 'x' ? 2 : (*p == 'u' ? 4 : 8);
+  for (p++; digits < max && *p != 0 && strchr(HEX_DIGITS, *p) != NULL;
+       p++, digits++) {
+    value = value * 16 + (*p <= '9' ? *p - '0' : (*p | 0x20) - 'a' + 10);
+  }
+
+  if (digits == 0) {
+    /* Not an escape after all */
+    out_append(out, *s, 2);
+  } else if (max == 2 || value < 0x80) {
+    out_char(out, (char)value);
+  } else if (value > UNICODE_MAX || !utf8_locale()) {
+    /* No such character, or no UTF-8 to write it in: as bash, print the
+     * escape itself */
+    char escape[24];
+    int n = value <= 0xffff ? sprintf(escape, "\\u%04lX", value)
+                            : sprintf(escape, "\\U%08lX", value);
+    out_append(out, escape, n);
+  } else {
+    /* Encode the code point in UTF-8 */
+    char utf8[4];
+    int n = value < 0x800 ? 2 : (value < 0x10000 ? 3 : 4);
+    int i;
+    for (i = n - 1; i > 0; i--) {
+      utf8[i] = 0x80 | (value & 0x3f);
+      value >>= 6;
+    }
+    utf8[0] = (char)((0xf00 >> n) | value);
+    out_append(out, utf8, n);
+  }
+
+  *s = p;
+  return true;
+}
+
+/**
+ * Check whether characters are encoded in UTF-8, as the locale variables
+ * set now tell.
+ */
+static bool utf8_locale() {
+  static const char *vars[] = { "LC_ALL", "LC_CTYPE", "LANG" };
+  unsigned int i;
+
+  for (i = 0; i < sizeof(vars) / sizeof(vars[0]); i++) {
+    const char *value = getenv(vars[i]);
+    if (value != NULL && *value != 0) {
+      return strcasestr(value, "utf-8") != NULL ||
+             strcasestr(value, "utf8") != NULL;
+    }
+  }
+
+  return false;
+}
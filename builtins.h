@@ -0,0 +1,29 @@
+/******************************************************************************
+ * Mini Shell in Linux - internal commands
+ *****************************************************************************/
+
+#ifndef _BUILTINS_H
+#define _BUILTINS_H
+
+#include "parser.h"
+
+/**
+ * An internal command: gets the NULL terminated argument list (argv[0] is
+ * the name of the command) and returns its exit code, or SHELL_EXIT.
+ * It runs inside the shell, with its redirections already in place.
+ */
+typedef int (*builtin_t)(char **argv);
+
+/**
+ * Internal command called name, or NULL if there is none.
+ */
+builtin_t builtin_lookup(const char *name);
+
+/**
+ * Check whether the internal command name leaves the shell as it is (true,
+ * false, echo, pwd), unlike cd or exit. Such a command gives the same result
+ * whether it runs in the shell or in a subshell.
+ */
+bool builtin_pure(const char *name);
+
+#endif
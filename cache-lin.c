@@ -0,0 +1,219 @@
+/******************************************************************************
+ * Mini Shell in Linux - parse tree cache implementation
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cache.h"
+#include "ir.h"
+#include "minternals.h"
+#include "plan.h"
+#include "script.h"
+#include "utils.h"
+
+#define CACHE_BUCKETS 1024
+#define CACHE_ALIGN   (sizeof(void *))
+#define ALIGN(n)      (((n) + CACHE_ALIGN - 1) & ~(CACHE_ALIGN - 1))
+
+/**
+ * A cached line and its parse tree, stored in a single block: the entry,
+ * the text of the line, then the tree, thawed from its compact form (see
+ * ir.h): the nodes, in preorder, and then the strings.
+ */
+typedef struct cache_entry_t {
+  struct cache_entry_t *next;  /* Next entry in the same bucket */
+  struct cache_entry_t *newer; /* LRU list */
+  struct cache_entry_t *older;
+  uint64_t hash;
+  size_t length;
+  size_t size;
+  command_t *root;
+  char line[];
+} cache_entry_t;
+
+static cache_entry_t *buckets[CACHE_BUCKETS];
+static cache_entry_t *newest;
+static cache_entry_t *oldest;
+static size_t used;
+static size_t budget;
+static bool   initialized;
+
+/* Last tree handed out that is not in the cache, and the block it was
+ * thawed in when it came from a compiled script */
+static command_t *uncached;
+static void      *uncached_block;
+
+
+
+/* Declarations */
+static void lru_unlink (cache_entry_t *e);
+static void lru_push   (cache_entry_t *e);
+static void evict      ();
+static void insert     (cache_entry_t *e);
+
+
+
+/**
+ * Parse a line, reusing the tree of an identical line parsed earlier.
+ */
+command_t *cache_parse(const char *line, size_t length) {
+  command_t *root = NULL;
+  const ir_t *saved = NULL;
+  ir_t *ir = NULL;
+  uint64_t hash = 0;
+  cache_entry_t *e;
+
+  if (!initialized) {
+    char *value = getenv(CACHE_BUDGET_VAR);
+    budget = value != NULL ? strtoul(value, NULL, 0) : CACHE_DEFAULT_BUDGET;
+    initialized = true;
+  }
+
+  /* Lookup */
+  if (budget > 0) {
+    hash = fnv1a(line, length);
+    for (e = buckets[hash % CACHE_BUCKETS]; e != NULL; e = e->next) {
+      if (e->hash == hash && e->length == length &&
+          memcmp(e->line, line, length) == 0) {
+        lru_unlink(e);
+        lru_push(e);
+        return e->root;
+      }
+    }
+  }
+
+  /* A line of a compiled script comes with its tree: no need to parse it */
+  script_line_t kind = script_find(line, length, &saved);
+  if (kind == SCRIPT_EMPTY) {
+    return NULL;
+  }
+
+  if (kind != SCRIPT_TREE) {
+    bool parsed = parse_line_n(line, length, &root);
+    if (root != NULL) {
+      ir = ir_build(root);
+    }
+    if (kind == SCRIPT_UNKNOWN && (root == NULL || ir != NULL)) {
+      script_save(line, length, !parsed ? SCRIPT_ERROR :
+                                root == NULL ? SCRIPT_EMPTY : SCRIPT_TREE, ir);
+    }
+    if (root == NULL) {
+      return NULL;
+    }
+    saved = ir;
+  }
+
+  /* Keep a copy of the tree; the text of a here-document comes from the
+   * lines that follow, so it is not part of the key */
+  if (budget > 0 && saved != NULL && !ir_here_docs(saved)) {
+    size_t size = sizeof(cache_entry_t) + ALIGN(length) + ir_tree_size(saved);
+    e = size <= budget ? malloc(size) : NULL;
+    if (e != NULL) {
+      e->hash   = hash;
+      e->length = length;
+      e->size   = size;
+      memcpy(e->line, line, length);
+      e->root = ir_thaw(saved, e->line + ALIGN(length));
+      free(ir);
+
+      insert(e);
+      return e->root;
+    }
+  }
+
+  if (root == NULL) {
+    /* From the compiled script, which only lives as long as the input */
+    uncached_block = malloc(ir_tree_size(saved));
+    if (uncached_block == NULL) {
+      mfatal(ERR_ALLOCATION);
+    }
+    root = ir_thaw(saved, uncached_block);
+  }
+
+  free(ir);
+  uncached = root;
+  return root;
+}
+
+/**
+ * Done with a tree returned by cache_parse.
+ */
+void cache_release(command_t *root) {
+  if (root != NULL && root == uncached) {
+    plan_free_tree(root);
+  }
+  uncached = NULL;
+
+  free(uncached_block);
+  uncached_block = NULL;
+}
+
+
+
+/**
+ * Remove e from the LRU list.
+ */
+static void lru_unlink(cache_entry_t *e) {
+  if (e->newer != NULL) {
+    e->newer->older = e->older;
+  } else {
+    newest = e->older;
+  }
+  if (e->older != NULL) {
+    e->older->newer = e->newer;
+  } else {
+    oldest = e->newer;
+  }
+  e->newer = e->older = NULL;
+}
+
+/**
+ * Make e the most recently used entry.
+ */
+static void lru_push(cache_entry_t *e) {
+  e->newer = NULL;
+  e->older = newest;
+  if (newest != NULL) {
+    newest->newer = e;
+  } else {
+    oldest = e;
+  }
+  newest = e;
+}
+
+/**
+ * Drop the least recently used entry.
+ */
+static void evict() {
+  cache_entry_t *e = oldest;
+  cache_entry_t **link = &buckets[e->hash % CACHE_BUCKETS];
+
+  while (*link != e) {
+    link = &(*link)->next;
+  }
+  *link = e->next;
+
+  lru_unlink(e);
+  used -= e->size;
+  plan_free_tree(e->root);
+  free(e);
+}
+
+/**
+ * Add e to the cache, evicting old entries to stay within the budget.
+ */
+static void insert(cache_entry_t *e) {
+  while (used + e->size > budget) {
+    evict();
+  }
+
+  cache_entry_t **bucket = &buckets[e->hash % CACHE_BUCKETS];
+  e->next = *bucket;
+  *bucket = e;
+
+  lru_push(e);
+  used += e->size;
+}
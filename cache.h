@@ -0,0 +1,40 @@
+/******************************************************************************
+ * Mini Shell in Linux - parse tree cache
+ *****************************************************************************/
+
+#ifndef _CACHE_H
+#define _CACHE_H
+
+#include <stddef.h>
+
+#include "parser.h"
+
+/* Environment variable holding the memory budget of the cache, in bytes */
+#define CACHE_BUDGET_VAR "MINISHELL_PARSE_CACHE"
+#define CACHE_DEFAULT_BUDGET (1024 * 1024)
+
+/**
+ * Parse a line (see parse_line_n), reusing the tree of an identical line
+ * parsed earlier when there is one.
+ *
+ * Parse trees are kept in an LRU cache keyed by the text of the line, within
+ * the budget given by CACHE_BUDGET_VAR (0 disables the cache); lines with a
+ * here-document are never cached, since its text is not part of the line.
+ * Cached trees
+ * must be treated as read-only, apart from aux. They hold words, not their
+ * values: variables are still expanded when the command runs.
+ *
+ * Returns the root of the tree, or NULL for an empty line or a parse error.
+ * The tree stays valid until the next call. Once the line has run, call
+ * cache_release and then free_parse_memory.
+ */
+command_t *cache_parse(const char *line, size_t length);
+
+/**
+ * Done with a tree returned by cache_parse. A tree that did not make it into
+ * the cache has its command plans (aux) freed; cached trees keep theirs
+ * until they are evicted.
+ */
+void cache_release(command_t *root);
+
+#endif
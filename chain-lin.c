@@ -0,0 +1,131 @@
+/******************************************************************************
+ * Mini Shell in Linux - conditional chains implementation
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "builtins.h"
+#include "chain.h"
+#include "minternals.h"
+#include "utils.h"
+
+
+
+/* Declarations */
+static bool is_chain    (command_t *c);
+static int  count_leaves(command_t *c);
+static bool runnable    (command_t *leaf);
+static void compile     (chain_t *chain, command_t *c, int *next,
+                         int after_zero, int after_nonzero);
+
+
+
+/**
+ * State machine of the conditional chain rooted at c.
+ */
+chain_t *chain_get(command_t *c) {
+  if (!is_chain(c)) {
+    return NULL;
+  }
+
+  if (c->aux == NULL) {
+    int count = count_leaves(c);
+
+    /* One block: the chain, then its three arrays */
+    chain_t *chain = malloc(sizeof(chain_t) + count * sizeof(command_t *) +
+                            2 * count * sizeof(int));
+    if (chain == NULL) {
+      mfatal(ERR_ALLOCATION);
+    }
+    chain->leaves = (command_t **)(chain + 1);
+    chain->on_zero = (int *)(chain->leaves + count);
+    chain->on_nonzero = chain->on_zero + count;
+
+    chain->count = count;
+    int next = 0;
+    compile(chain, c, &next, count, count);
+
+    /* A chain the shell cannot run itself is remembered as empty */
+    int i;
+    for (i = 0; i < count; i++) {
+      if (!runnable(chain->leaves[i])) {
+        chain->count = 0;
+        break;
+      }
+    }
+
+    c->aux = chain;
+  }
+
+  chain_t *chain = c->aux;
+  return chain->count > 0 ? chain : NULL;
+}
+
+
+
+/**
+ * Check whether c is an && or || node.
+ */
+static bool is_chain(command_t *c) {
+  return c->op == OP_CONDITIONAL_ZERO || c->op == OP_CONDITIONAL_NZERO;
+}
+
+/**
+ * Number of leaves of the conditional chain rooted at c.
+ */
+static int count_leaves(command_t *c) {
+  if (!is_chain(c)) {
+    return 1;
+  }
+  return count_leaves(c->cmd1) + count_leaves(c->cmd2);
+}
+
+/**
+ * Check whether leaf may run outside of a subshell.
+ */
+static bool runnable(command_t *leaf) {
+  if (leaf->op == OP_PIPE) {
+    /* Every stage runs in a process of its own anyway */
+    return true;
+  }
+  if (leaf->op != OP_NONE) {
+    return false;
+  }
+
+  /* The name must be known now: a plain word, not name=value */
+  word_t *verb = leaf->scmd->verb;
+  if (verb->expand || verb->next_part != NULL) {
+    return false;
+  }
+
+  return builtin_lookup(verb->string) == NULL || builtin_pure(verb->string);
+}
+
+/**
+ * Number the leaves of c from *next on and fill in their transitions; once c
+ * is over with exit code 0 (non zero), the chain goes on with leaf
+ * after_zero (after_nonzero).
+ */
+static void compile(chain_t *chain, command_t *c, int *next, int after_zero,
+    int after_nonzero) {
+  if (!is_chain(c)) {
+    chain->leaves[*next] = c;
+    chain->on_zero[*next] = after_zero;
+    chain->on_nonzero[*next] = after_nonzero;
+    (*next)++;
+    return;
+  }
+
+  /* cmd2 starts right after the leaves of cmd1 */
+  int second = *next + count_leaves(c->cmd1);
+
+  if (c->op == OP_CONDITIONAL_ZERO) {
+    /* cmd1 && cmd2: cmd2 runs only after cmd1 succeeded */
+    compile(chain, c->cmd1, next, second, after_nonzero);
+  } else {
+    /* cmd1 || cmd2: cmd2 runs only after cmd1 failed */
+    compile(chain, c->cmd1, next, after_zero, second);
+  }
+  compile(chain, c->cmd2, next, after_zero, after_nonzero);
+}
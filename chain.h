@@ -0,0 +1,37 @@
+/******************************************************************************
+ * Mini Shell in Linux - conditional chains
+ *****************************************************************************/
+
+#ifndef _CHAIN_H
+#define _CHAIN_H
+
+#include "parser.h"
+
+/**
+ * A chain of && and || nodes compiled into a small state machine over its
+ * leaves (the commands of the chain, left to right). After leaf i ends, the
+ * next leaf to run is on_zero[i] if its exit code is 0, on_nonzero[i]
+ * otherwise; count means that the chain is over, with that exit code.
+ *
+ * Every leaf is either a pipe chain or a simple command that may run outside
+ * of a subshell: an external command or an internal command that leaves the
+ * shell unchanged (see builtin_pure). This lets a branch of a parallel chain
+ * be run by the shell itself instead of by a copy of the shell.
+ */
+typedef struct {
+  int count;
+  command_t **leaves;
+  int *on_zero;
+  int *on_nonzero;
+} chain_t;
+
+/**
+ * State machine of the conditional chain rooted at c, compiled the first time
+ * it is needed and kept in c->aux (a single block, released with free).
+ * Returns NULL if c is not a conditional chain, or if one of its leaves has to
+ * run in a subshell (a variable assignment, cd, exit, a command whose name
+ * comes from a variable).
+ */
+chain_t *chain_get(command_t *c);
+
+#endif
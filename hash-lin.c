@@ -0,0 +1,227 @@
+/******************************************************************************
+ * Mini Shell in Linux - resolved executables implementation
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/stat.h>
+
+#include <unistd.h>
+
+#include "hash.h"
+#include "minternals.h"
+#include "utils.h"
+
+/* Number of buckets of the table (a power of 2) */
+#define HASH_BUCKETS 64
+
+/**
+ * A command name and the executable it runs; one allocation holds both.
+ */
+typedef struct hash_entry {
+  struct hash_entry *next; /* Next entry in the same bucket */
+  unsigned int hits;
+  char *path;
+  char name[];
+} hash_entry_t;
+
+
+
+/* Declarations */
+static hash_entry_t **bucket_of(const char *name);
+static hash_entry_t *search    (const char *name);
+static hash_entry_t *insert    (const char *name);
+static bool          executable(const char *path);
+
+static hash_entry_t *buckets[HASH_BUCKETS];
+static int count;
+
+/* Last command found through a relative directory of PATH: not in the table,
+ * since the file it names changes with the current directory */
+static hash_entry_t *relative;
+
+
+
+/**
+ * Path of the executable the command name runs.
+ */
+const char *hash_lookup(const char *name) {
+  if (strchr(name, '/') != NULL) {
+    return name;
+  }
+
+  hash_entry_t *e = *bucket_of(name);
+  for (; e != NULL; e = e->next) {
+    if (strcmp(e->name, name) == 0) {
+      e->hits++;
+      return e->path;
+    }
+  }
+
+  e = insert(name);
+  if (e == NULL) {
+    return NULL;
+  }
+
+  e->hits = 1;
+  return e->path;
+}
+
+/**
+ * Look name up in PATH again, replacing what is remembered about it.
+ */
+bool hash_remember(const char *name) {
+  hash_forget(name);
+  return insert(name) != NULL;
+}
+
+/**
+ * Drop what is remembered about name.
+ */
+void hash_forget(const char *name) {
+  hash_entry_t **e = bucket_of(name);
+
+  for (; *e != NULL; e = &(*e)->next) {
+    if (strcmp((*e)->name, name) == 0) {
+      hash_entry_t *gone = *e;
+      *e = gone->next;
+      free(gone);
+      count--;
+      return;
+    }
+  }
+}
+
+/**
+ * Forget every command.
+ */
+void hash_clear() {
+  int i;
+
+  for (i = 0; i < HASH_BUCKETS; i++) {
+    while (buckets[i] != NULL) {
+      hash_entry_t *next = buckets[i]->next;
+      free(buckets[i]);
+      buckets[i] = next;
+    }
+  }
+  count = 0;
+}
+
+/**
+ * List the remembered commands.
+ */
+int hash_print() {
+  int i;
+
+  if (count == 0) {
+    fprintf(stderr, "hash: hash table empty\n");
+    return EXIT_SUCCESS;
+  }
+
+  printf("hits\tcommand\n");
+  for (i = 0; i < HASH_BUCKETS; i++) {
+    hash_entry_t *e;
+    for (e = buckets[i]; e != NULL; e = e->next) {
+      printf("%4u\t%s\n", e->hits, e->path);
+    }
+  }
+  fflush(stdout);
+
+  return EXIT_SUCCESS;
+}
+
+
+
+/**
+ * Head of the bucket name falls into.
+ */
+static hash_entry_t **bucket_of(const char *name) {
+  return &buckets[fnv1a(name, strlen(name)) & (HASH_BUCKETS - 1)];
+}
+
+/**
+ * Walk PATH for name, in the order execvp does. An empty directory stands
+ * for the current one. Returns a new entry (not in the table), or NULL.
+ */
+static hash_entry_t *search(const char *name) {
+  const char *dirs = getenv("PATH");
+  size_t name_length = strlen(name);
+
+  if (dirs == NULL) {
+    dirs = HASH_DEFAULT_PATH;
+  }
+
+  while (true) {
+    const char *end = strchrnul(dirs, ':');
+    size_t dir_length = end - dirs;
+
+    /* name, then the path: dir/name or just name for an empty dir */
+    hash_entry_t *e = malloc(sizeof(hash_entry_t) + 2 * name_length +
+                             dir_length + 3);
+    if (e == NULL) {
+      mfatal(ERR_ALLOCATION);
+    }
+
+    memcpy(e->name, name, name_length + 1);
+    e->path = e->name + name_length + 1;
+    if (dir_length == 0) {
+      memcpy(e->path, name, name_length + 1);
+    } else {
+      memcpy(e->path, dirs, dir_length);
+      e->path[dir_length] = '/';
+      memcpy(e->path + dir_length + 1, name, name_length + 1);
+    }
+
+    if (executable(e->path)) {
+      return e;
+    }
+    free(e);
+
+    if (*end == 0) {
+      return NULL;
+    }
+    dirs = end + 1;
+  }
+}
+
+/**
+ * Search name and add it to the table, with no hits. Returns the entry, or
+ * NULL if it was not found. An entry with a relative path is kept aside
+ * instead, until the next search.
+ */
+static hash_entry_t *insert(const char *name) {
+  hash_entry_t *e = search(name);
+
+  free(relative);
+  relative = NULL;
+
+  if (e == NULL) {
+    return NULL;
+  }
+
+  if (e->path[0] != '/') {
+    relative = e;
+    return e;
+  }
+
+  hash_entry_t **b = bucket_of(name);
+  e->next = *b;
+  e->hits = 0;
+  *b = e;
+  count++;
+
+  return e;
+}
+
+/**
+ * Check whether path is a regular file the shell may execute.
+ */
+static bool executable(const char *path) {
+  struct stat st;
+
+  return stat(path, &st) == 0 && S_ISREG(st.st_mode) &&
+         access(path, X_OK) == 0;
+}
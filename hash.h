@@ -0,0 +1,48 @@
+/******************************************************************************
+ * Mini Shell in Linux - resolved executables
+ *****************************************************************************/
+
+#ifndef _HASH_H
+#define _HASH_H
+
+#include "parser.h"
+
+/* Search path used when PATH is not set (the one of execvp) */
+#define HASH_DEFAULT_PATH "/bin:/usr/bin"
+
+/**
+ * Path of the executable the command name runs, as execvp would find it by
+ * walking PATH. Names containing a '/' are returned as they are. The answer
+ * is remembered, so the next lookup costs no system call.
+ *
+ * Returns NULL when no directory in PATH holds an executable called name.
+ * The string stays valid until hash_forget or hash_clear. A command found
+ * through a relative directory of PATH (empty, or such as .) is not
+ * remembered, since changing directory changes the file it names; its path
+ * stays valid until the next lookup.
+ */
+const char *hash_lookup(const char *name);
+
+/**
+ * Look name up in PATH again and remember the result, without counting it as
+ * a hit (hash name). Returns false if it was not found.
+ */
+bool hash_remember(const char *name);
+
+/**
+ * Drop what is remembered about name (its executable moved).
+ */
+void hash_forget(const char *name);
+
+/**
+ * Forget every command (hash -r, or PATH changed).
+ */
+void hash_clear();
+
+/**
+ * List the remembered commands with the number of times each was looked up,
+ * as the hash builtin of bash does. Returns the exit code of the builtin.
+ */
+int hash_print();
+
+#endif
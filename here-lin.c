@@ -0,0 +1,190 @@
+/******************************************************************************
+ * Mini Shell in Linux - here-documents and here-strings implementation
+ *****************************************************************************/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/mman.h>
+#include <sys/uio.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "here.h"
+#include "input.h"
+#include "minternals.h"
+#include "utils.h"
+
+
+
+/* Declarations */
+static void  read_text (simple_command_t *s);
+static char *delimiter (word_t *w);
+static int   write_all (int fd, const char *text, bool newline);
+
+
+
+/**
+ * Check whether the tree rooted at c has a here-document.
+ */
+bool here_docs(command_t *c) {
+  if (c->op == OP_NONE) {
+    return (c->scmd->io_flags & IO_HERE_DOC) != 0;
+  }
+  return here_docs(c->cmd1) || here_docs(c->cmd2);
+}
+
+/**
+ * Read the text of the here-documents of the tree rooted at c.
+ */
+void here_read(command_t *c) {
+  if (c->op == OP_NONE) {
+    if (c->scmd->io_flags & IO_HERE_DOC) {
+      read_text(c->scmd);
+    }
+    return;
+  }
+  here_read(c->cmd1);
+  here_read(c->cmd2);
+}
+
+/**
+ * A descriptor to read text from.
+ */
+int here_open(const char *text, bool newline) {
+  size_t length = strlen(text) + (newline ? 1 : 0);
+  int fd;
+
+  if (length <= HERE_PIPE_MAX) {
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) != 0) {
+      return -1;
+    }
+    if (write_all(fds[1], text, newline) != 0) {
+      close(fds[0]);
+      close(fds[1]);
+      return -1;
+    }
+    close(fds[1]);
+    return fds[0];
+  }
+
+  fd = memfd_create("here-document", MFD_CLOEXEC);
+  if (fd < 0) {
+    return -1;
+  }
+  if (write_all(fd, text, newline) != 0 || lseek(fd, 0, SEEK_SET) != 0) {
+    int error = errno;
+    close(fd);
+    errno = error;
+    return -1;
+  }
+
+  return fd;
+}
+
+
+
+/**
+ * Read the text of the here-document of s, up to its delimiter.
+ */
+static void read_text(simple_command_t *s) {
+  char *end = delimiter(s->here);
+  size_t end_length = strlen(end);
+  char *text = NULL;
+  size_t length = 0, size = 0;
+
+  while (true) {
+    size_t line_length;
+    const char *line = read_line(&line_length);
+
+    if (line == NULL) {
+      fprintf(stderr, "warning: here-document delimited by end-of-file "
+                      "(wanted `%s')\n", end);
+      break;
+    }
+    if (line_length == end_length && memcmp(line, end, end_length) == 0) {
+      break;
+    }
+
+    if (length + line_length + 1 > size) {
+      size = 2 * (length + line_length + 1);
+      text = realloc(text, size);
+      if (text == NULL) {
+        mfatal(ERR_ALLOCATION);
+      }
+    }
+    memcpy(text + length, line, line_length);
+    length += line_length;
+    text[length++] = '\n';
+  }
+
+  /* Give the text the lifetime of the tree */
+  s->here_doc = parserStrndup(text != NULL ? text : "", length);
+
+  free(text);
+  free(end);
+}
+
+/**
+ * The delimiter of a here-document, as written: variables are not expanded.
+ */
+static char *delimiter(word_t *w) {
+  size_t length = 0;
+  word_t *part;
+
+  for (part = w; part != NULL; part = part->next_part) {
+    length += strlen(part->string) + (part->expand ? 1 : 0);
+  }
+
+  char *end = malloc(length + 1);
+  if (end == NULL) {
+    mfatal(ERR_ALLOCATION);
+  }
+
+  end[0] = 0;
+  for (part = w; part != NULL; part = part->next_part) {
+    if (part->expand) {
+      strcat(end, "$");
+    }
+    strcat(end, part->string);
+  }
+
+  return end;
+}
+
+/**
+ * Write text (and a '\n' if newline) to fd.
+ */
+static int write_all(int fd, const char *text, bool newline) {
+  struct iovec iov[2] = {
+    { (void *)text, strlen(text) },
+    { "\n", newline ? 1 : 0 },
+  };
+  int i = 0;
+
+  while (i < 2) {
+    ssize_t n = writev(fd, iov + i, 2 - i);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+
+    /* Skip what was written */
+    while (i < 2 && (size_t)n >= iov[i].iov_len) {
+      n -= iov[i].iov_len;
+      i++;
+    }
+    if (i < 2) {
+      iov[i].iov_base = (char *)iov[i].iov_base + n;
+      iov[i].iov_len -= n;
+    }
+  }
+
+  return 0;
+}
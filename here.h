@@ -0,0 +1,39 @@
+/******************************************************************************
+ * Mini Shell in Linux - here-documents and here-strings
+ *****************************************************************************/
+
+#ifndef _HERE_H
+#define _HERE_H
+
+#include <stddef.h>
+
+#include "parser.h"
+
+/* Texts up to this size go through a pipe, which takes them without
+ * blocking; larger ones through an in-memory file */
+#define HERE_PIPE_MAX 4096
+
+/**
+ * Check whether the tree rooted at c has a here-document.
+ */
+bool here_docs(command_t *c);
+
+/**
+ * Read the text of the here-documents of the tree rooted at c from the
+ * input (see read_line), in the order they appear in the command line, and
+ * store it in here_doc. Each text ends at the line that holds only its
+ * delimiter (taken literally), or at the end of the input. The text is taken
+ * as it is, without expanding variables, and lives as long as the tree.
+ */
+void here_read(command_t *c);
+
+/**
+ * A descriptor to read text from (text and, when newline is true, a '\n'),
+ * without any process writing it: the text is written once, to a pipe for
+ * short texts or to a memfd (positioned back at its start, so it can be
+ * seeked like a file) for longer ones. The descriptor is close-on-exec.
+ * Returns -1 (errno is set) on failure.
+ */
+int here_open(const char *text, bool newline);
+
+#endif
@@ -0,0 +1,182 @@
+/******************************************************************************
+ * Mini Shell in Linux - input implementation
+ *****************************************************************************/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "input.h"
+#include "minternals.h"
+#include "utils.h"
+
+/**
+ * Buffered reader over a file descriptor, or over a file mapped in memory
+ * (mapped == true, fd == -1). Bytes in [start, end) have been read but not
+ * returned yet; [start, scan) is known to contain no '\n'.
+ */
+typedef struct {
+  int fd;
+  bool mapped;
+  char *buf;
+  size_t size;
+  size_t start;
+  size_t scan;
+  size_t end;
+} input_t;
+
+static input_t input = { STDIN_FILENO, false, NULL, 0, 0, 0, 0 };
+
+
+
+/* Declarations */
+static ssize_t fill(input_t *in);
+
+
+
+/**
+ * Read the commands from the script at path (batch mode).
+ */
+int input_open(const char *path) {
+  input_t *in = &input;
+
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return -1;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return -1;
+  }
+
+  in->fd = fd;
+  if (!S_ISREG(st.st_mode)) {
+    /* Pipes and the like are read like the standard input */
+    return 0;
+  }
+
+  if (st.st_size > 0) {
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+      /* Fall back to read(2) */
+      return 0;
+    }
+    madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+    in->buf  = map;
+    in->size = in->end = st.st_size;
+  }
+
+  close(fd);
+  in->fd = -1;
+  in->mapped = true;
+
+  return 0;
+}
+
+/**
+ * Readline from mini-shell.
+ */
+const char *read_line(size_t *length) {
+  input_t *in = &input;
+
+  for (;;) {
+    char *eol = NULL;
+    if (in->scan < in->end) {
+      eol = memchr(in->buf + in->scan, '\n', in->end - in->scan);
+    }
+    if (eol != NULL) {
+      const char *line = in->buf + in->start;
+      *length = eol - line;
+      in->start = in->scan = eol - in->buf + 1;
+      return line;
+    }
+    in->scan = in->end;
+
+    if (in->mapped) {
+      break;
+    }
+
+    ssize_t rc = fill(in);
+    if (rc < 0) {
+      perror("Could not read input");
+      return NULL;
+    }
+    if (rc == 0) {
+      break;
+    }
+  }
+
+  /* End of input: return the last line even if it has no '\n' */
+  if (in->start == in->end) {
+    return NULL;
+  }
+
+  const char *line = in->buf + in->start;
+  *length = in->end - in->start;
+  in->start = in->scan = in->end;
+  return line;
+}
+
+/**
+ * The script mapped by input_open.
+ */
+const char *input_mapping(size_t *size) {
+  if (!input.mapped || input.buf == NULL) {
+    return NULL;
+  }
+
+  *size = input.size;
+  return input.buf;
+}
+
+
+
+/**
+ * Read more bytes after the pending ones. Consumed bytes are dropped first;
+ * the buffer is doubled when the pending bytes fill it. Returns the number
+ * of bytes read, 0 at the end of the input and -1 on error.
+ */
+static ssize_t fill(input_t *in) {
+  if (in->start > 0) {
+    memmove(in->buf, in->buf + in->start, in->end - in->start);
+    in->end  -= in->start;
+    in->scan -= in->start;
+    in->start = 0;
+  }
+
+  /* Keep at least INPUT_CHUNK bytes free */
+  if (in->size - in->end < INPUT_CHUNK) {
+    size_t size = in->size == 0 ? INPUT_CHUNK : in->size;
+    while (size - in->end < INPUT_CHUNK) {
+      size *= 2;
+    }
+
+    char *buf = realloc(in->buf, size);
+    if (buf == NULL) {
+      mfatal(ERR_ALLOCATION);
+    }
+    in->buf  = buf;
+    in->size = size;
+  }
+
+  ssize_t rc;
+  do {
+    rc = read(in->fd, in->buf + in->end, in->size - in->end);
+  } while (rc < 0 && errno == EINTR);
+
+  if (rc > 0) {
+    in->end += rc;
+  }
+
+  return rc;
+}
@@ -0,0 +1,40 @@
+/******************************************************************************
+ * Mini Shell in Linux - input
+ *****************************************************************************/
+
+#ifndef _INPUT_H
+#define _INPUT_H
+
+#include <stddef.h>
+
+/* Initial size of the line buffer and minimum size of a read(2) */
+#define INPUT_CHUNK (64 * 1024)
+
+/**
+ * Read the commands from the script at path instead of the standard input
+ * (batch mode). A regular file is mapped in memory as a whole and lines are
+ * handed out straight from the mapping. Returns 0 or -1 (errno is set).
+ */
+int input_open(const char *path);
+
+/**
+ * Readline from mini-shell.
+ *
+ * Returns the next line, without its '\n', and stores its length in *length.
+ * The line is not '\0' terminated; it lives in memory owned by the input
+ * layer and stays valid until the next call. Returns NULL at the end of the
+ * input.
+ *
+ * When reading from a file descriptor, the buffer grows geometrically and is
+ * kept from one line to the next, so a line of n bytes costs O(n) and no
+ * allocation once the buffer is large enough.
+ */
+const char *read_line(size_t *length);
+
+/**
+ * The script mapped by input_open and its size, or NULL when the input is
+ * not a mapped file. Lines returned by read_line point into it.
+ */
+const char *input_mapping(size_t *size);
+
+#endif
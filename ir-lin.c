@@ -0,0 +1,413 @@
+/******************************************************************************
+ * Mini Shell in Linux - compact command representation implementation
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ir.h"
+#include "minternals.h"
+#include "utils.h"
+
+/**
+ * Where the next node, part and string of a block being built go.
+ */
+typedef struct {
+  ir_node_t *nodes;
+  ir_part_t *parts;
+  char *strings;
+  uint32_t node;
+  uint32_t part;
+  uint32_t string;
+} builder_t;
+
+/**
+ * Where the next simple command of a tree being thawed goes, and the parts
+ * and strings it refers to.
+ */
+typedef struct {
+  const ir_t *ir;
+  command_t *commands;
+  simple_command_t *simple;
+  word_t *words;
+  char *strings;
+} thaw_t;
+
+
+
+/* Declarations */
+static void     measure_command (command_t *c, uint64_t *nodes,
+                                 uint64_t *simple, uint64_t *parts,
+                                 uint64_t *strings);
+static void     measure_words   (word_t *w, uint64_t *parts,
+                                 uint64_t *strings);
+
+static void     build_command   (command_t *c, builder_t *b);
+static uint32_t build_words     (word_t *w, builder_t *b);
+static uint32_t build_string    (const char *string, builder_t *b);
+
+static bool     valid_command   (const ir_t *ir, uint32_t i, uint32_t *next,
+                                 uint32_t *simple);
+static bool     valid_list      (const ir_t *ir, uint32_t first, bool word);
+
+static command_t *thaw_command  (thaw_t *t, uint32_t i, command_t *up);
+static word_t    *thaw_words    (thaw_t *t, uint32_t first);
+
+
+
+/**
+ * The compact form of the tree rooted at root.
+ */
+ir_t *ir_build(command_t *root) {
+  uint64_t nodes = 0, simple = 0, parts = 0, strings = 0;
+  measure_command(root, &nodes, &simple, &parts, &strings);
+
+  uint64_t size = sizeof(ir_t) + nodes * sizeof(ir_node_t) +
+                  parts * sizeof(ir_part_t) + strings;
+  if (size > UINT32_MAX) {
+    return NULL;
+  }
+
+  ir_t *ir = malloc(size);
+  if (ir == NULL) {
+    mfatal(ERR_ALLOCATION);
+  }
+
+  ir->magic   = IR_MAGIC;
+  ir->size    = size;
+  ir->nodes   = nodes;
+  ir->simple  = simple;
+  ir->parts   = parts;
+  ir->strings = strings;
+
+  builder_t b;
+  b.nodes   = (ir_node_t *)IR_NODES(ir);
+  b.parts   = (ir_part_t *)IR_PARTS(ir);
+  b.strings = (char *)IR_STRINGS(ir);
+  b.node = b.part = b.string = 0;
+  build_command(root, &b);
+
+  return ir;
+}
+
+/**
+ * Check that data holds a well-formed block.
+ */
+bool ir_valid(const void *data, size_t size) {
+  const ir_t *ir = data;
+  uint32_t next, simple = 0;
+
+  if (size < sizeof(ir_t) || (uintptr_t)data % sizeof(uint32_t) != 0) {
+    return false;
+  }
+  if (ir->magic != IR_MAGIC || ir->size != size || ir->nodes == 0) {
+    return false;
+  }
+
+  uint64_t expected = sizeof(ir_t) + (uint64_t)ir->nodes * sizeof(ir_node_t) +
+                      (uint64_t)ir->parts * sizeof(ir_part_t) + ir->strings;
+  if (expected != size) {
+    return false;
+  }
+
+  /* Any offset in the table then starts a NUL-terminated string */
+  if (ir->strings > 0 && IR_STRINGS(ir)[ir->strings - 1] != '\0') {
+    return false;
+  }
+
+  if (!valid_command(ir, 0, &next, &simple)) {
+    return false;
+  }
+
+  return next == ir->nodes && simple == ir->simple;
+}
+
+/**
+ * Bytes needed by ir_thaw.
+ */
+size_t ir_tree_size(const ir_t *ir) {
+  return ir->nodes * sizeof(command_t) + ir->simple * sizeof(simple_command_t) +
+         ir->parts * sizeof(word_t) + ir->strings;
+}
+
+/**
+ * Check whether the command line of ir has a here-document.
+ */
+bool ir_here_docs(const ir_t *ir) {
+  uint32_t i;
+
+  for (i = 0; i < ir->nodes; i++) {
+    if (IR_NODES(ir)[i].io_flags & IO_HERE_DOC) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Rebuild the tree of ir in block.
+ */
+command_t *ir_thaw(const ir_t *ir, void *block) {
+  thaw_t t;
+
+  t.ir       = ir;
+  t.commands = block;
+  t.simple   = (simple_command_t *)(t.commands + ir->nodes);
+  t.words    = (word_t *)(t.simple + ir->simple);
+  t.strings  = (char *)(t.words + ir->parts);
+  memcpy(t.strings, IR_STRINGS(ir), ir->strings);
+
+  return thaw_command(&t, 0, NULL);
+}
+
+
+
+/**
+ * Count the nodes, parts and string bytes of the tree rooted at c.
+ */
+static void measure_command(command_t *c, uint64_t *nodes, uint64_t *simple,
+    uint64_t *parts, uint64_t *strings) {
+  (*nodes)++;
+
+  if (c->op == OP_NONE) {
+    simple_command_t *s = c->scmd;
+    (*simple)++;
+    measure_words(s->verb, parts, strings);
+    measure_words(s->params, parts, strings);
+    measure_words(s->in, parts, strings);
+    measure_words(s->out, parts, strings);
+    measure_words(s->err, parts, strings);
+    measure_words(s->here, parts, strings);
+    if (s->here_doc != NULL) {
+      *strings += strlen(s->here_doc) + 1;
+    }
+    return;
+  }
+
+  measure_command(c->cmd1, nodes, simple, parts, strings);
+  measure_command(c->cmd2, nodes, simple, parts, strings);
+}
+
+/**
+ * Count the parts and string bytes of a list of words.
+ */
+static void measure_words(word_t *w, uint64_t *parts, uint64_t *strings) {
+  word_t *part;
+
+  for (; w != NULL; w = w->next_word) {
+    for (part = w; part != NULL; part = part->next_part) {
+      (*parts)++;
+      *strings += strlen(part->string) + 1;
+    }
+  }
+}
+
+/**
+ * Add the tree rooted at c, in preorder.
+ */
+static void build_command(command_t *c, builder_t *b) {
+  ir_node_t *node = &b->nodes[b->node++];
+  int i;
+
+  node->op       = c->op;
+  node->cmd2     = IR_NONE;
+  node->io_flags = 0;
+  node->here_doc = IR_NONE;
+  for (i = 0; i < IR_LISTS; i++) {
+    node->lists[i] = IR_NONE;
+  }
+
+  if (c->op == OP_NONE) {
+    simple_command_t *s = c->scmd;
+    node->io_flags          = s->io_flags;
+    node->lists[IR_VERB]    = build_words(s->verb, b);
+    node->lists[IR_PARAMS]  = build_words(s->params, b);
+    node->lists[IR_IN]      = build_words(s->in, b);
+    node->lists[IR_OUT]     = build_words(s->out, b);
+    node->lists[IR_ERR]     = build_words(s->err, b);
+    node->lists[IR_HERE]    = build_words(s->here, b);
+    if (s->here_doc != NULL) {
+      node->here_doc = build_string(s->here_doc, b);
+    }
+    return;
+  }
+
+  build_command(c->cmd1, b);
+  node->cmd2 = b->node;
+  build_command(c->cmd2, b);
+}
+
+/**
+ * Add a list of words; the index of its first part, or IR_NONE.
+ */
+static uint32_t build_words(word_t *w, builder_t *b) {
+  uint32_t first = w != NULL ? b->part : IR_NONE;
+  ir_part_t *p = NULL;
+  word_t *part;
+
+  for (; w != NULL; w = w->next_word) {
+    for (part = w; part != NULL; part = part->next_part) {
+      p = &b->parts[b->part++];
+      p->string = build_string(part->string, b);
+      p->flags  = part->expand ? IR_EXPAND : 0;
+    }
+    p->flags |= IR_WORD_END;
+  }
+
+  if (p != NULL) {
+    p->flags |= IR_LIST_END;
+  }
+
+  return first;
+}
+
+/**
+ * Add a string to the string table; its offset.
+ */
+static uint32_t build_string(const char *string, builder_t *b) {
+  uint32_t offset = b->string;
+  size_t length = strlen(string) + 1;
+
+  memcpy(b->strings + offset, string, length);
+  b->string += length;
+
+  return offset;
+}
+
+/**
+ * Check the subtree at node i; next is set to the node after it.
+ */
+static bool valid_command(const ir_t *ir, uint32_t i, uint32_t *next,
+    uint32_t *simple) {
+  const ir_node_t *node = &IR_NODES(ir)[i];
+  int k;
+
+  if (i >= ir->nodes || node->op >= OP_DUMMY) {
+    return false;
+  }
+
+  if (node->op == OP_NONE) {
+    if (node->lists[IR_VERB] == IR_NONE) {
+      return false;
+    }
+    /* The verb and a here-document or here-string are single words, as
+     * the grammar gives them */
+    for (k = 0; k < IR_LISTS; k++) {
+      if (!valid_list(ir, node->lists[k], k == IR_VERB || k == IR_HERE)) {
+        return false;
+      }
+    }
+    if (node->here_doc != IR_NONE && node->here_doc >= ir->strings) {
+      return false;
+    }
+    (*simple)++;
+    *next = i + 1;
+    return true;
+  }
+
+  /* The first command follows, the second one comes right after it */
+  if (!valid_command(ir, i + 1, next, simple) || node->cmd2 != *next) {
+    return false;
+  }
+  return valid_command(ir, node->cmd2, next, simple);
+}
+
+/**
+ * Check the list of words starting at part first; with word, that it holds
+ * a single word.
+ */
+static bool valid_list(const ir_t *ir, uint32_t first, bool word) {
+  const ir_part_t *parts = IR_PARTS(ir);
+  uint32_t k;
+
+  if (first == IR_NONE) {
+    return true;
+  }
+
+  for (k = first; k < ir->parts; k++) {
+    if (parts[k].string >= ir->strings) {
+      return false;
+    }
+    if (parts[k].flags & IR_LIST_END) {
+      return (parts[k].flags & IR_WORD_END) != 0;
+    }
+    if (word && (parts[k].flags & IR_WORD_END)) {
+      return false;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Rebuild the subtree at node i.
+ */
+static command_t *thaw_command(thaw_t *t, uint32_t i, command_t *up) {
+  const ir_node_t *node = &IR_NODES(t->ir)[i];
+  command_t *c = &t->commands[i];
+
+  c->up   = up;
+  c->op   = node->op;
+  c->aux  = NULL;
+  c->scmd = NULL;
+  c->cmd1 = c->cmd2 = NULL;
+
+  if (node->op != OP_NONE) {
+    c->cmd1 = thaw_command(t, i + 1, c);
+    c->cmd2 = thaw_command(t, node->cmd2, c);
+    return c;
+  }
+
+  simple_command_t *s = t->simple++;
+  s->verb     = thaw_words(t, node->lists[IR_VERB]);
+  s->params   = thaw_words(t, node->lists[IR_PARAMS]);
+  s->in       = thaw_words(t, node->lists[IR_IN]);
+  s->out      = thaw_words(t, node->lists[IR_OUT]);
+  s->err      = thaw_words(t, node->lists[IR_ERR]);
+  s->here     = thaw_words(t, node->lists[IR_HERE]);
+  s->here_doc = node->here_doc != IR_NONE ? t->strings + node->here_doc
+                                          : NULL;
+  s->io_flags = node->io_flags;
+  s->up       = c;
+  s->aux      = NULL;
+  c->scmd     = s;
+
+  return c;
+}
+
+/**
+ * Rebuild the list of words starting at part first.
+ */
+static word_t *thaw_words(thaw_t *t, uint32_t first) {
+  const ir_part_t *parts = IR_PARTS(t->ir);
+  word_t *word, *w;
+  uint32_t k;
+
+  if (first == IR_NONE) {
+    return NULL;
+  }
+
+  word = &t->words[first];
+  for (k = first; ; k++) {
+    w = &t->words[k];
+    w->string    = t->strings + parts[k].string;
+    w->expand    = (parts[k].flags & IR_EXPAND) ? true : false;
+    w->next_part = NULL;
+    w->next_word = NULL;
+
+    if (!(parts[k].flags & IR_WORD_END)) {
+      w->next_part = w + 1;
+    } else if (parts[k].flags & IR_LIST_END) {
+      break;
+    } else {
+      /* The next part starts the next word */
+      word->next_word = w + 1;
+      word = w + 1;
+    }
+  }
+
+  return &t->words[first];
+}
@@ -0,0 +1,107 @@
+/******************************************************************************
+ * Mini Shell in Linux - compact command representation
+ *
+ * A storage format only: the parser still builds command_t trees, ir_build
+ * copies one into a block without pointers after parsing, and the shell runs
+ * the command_t tree that ir_thaw rebuilds from the block. It exists so that
+ * trees can be kept in the parse cache and in compiled scripts (.msc).
+ *****************************************************************************/
+
+#ifndef _IR_H
+#define _IR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "parser.h"
+
+#define IR_MAGIC 0x3152494dU /* "MIR1", in the byte order of the machine */
+#define IR_NONE  0xffffffffU /* No node, word or string */
+
+/* The word lists of a simple command, indices in ir_node_t::lists */
+#define IR_VERB   0
+#define IR_PARAMS 1
+#define IR_IN     2
+#define IR_OUT    3
+#define IR_ERR    4
+#define IR_HERE   5
+#define IR_LISTS  6
+
+/* Flags of a word part */
+#define IR_EXPAND    0x1 /* The part names a variable */
+#define IR_WORD_END  0x2 /* Last part of its word */
+#define IR_LIST_END  0x4 /* Last part of the last word of its list */
+
+/**
+ * A command: an operator with two commands, or a simple command. Nodes are in
+ * preorder, so the first command of an operator is the node that follows it.
+ */
+typedef struct {
+  uint32_t op;              /* operator_t */
+  uint32_t cmd2;            /* Operators: the node of the second command */
+  uint32_t io_flags;        /* Simple commands: as in simple_command_t */
+  uint32_t here_doc;        /* Simple commands: string of the here-document */
+  uint32_t lists[IR_LISTS]; /* Simple commands: first part of each list */
+} ir_node_t;
+
+/**
+ * A part of a word. The parts of a word, and the words of a list, are
+ * consecutive; the flags tell where they end.
+ */
+typedef struct {
+  uint32_t string; /* Offset in the string table */
+  uint32_t flags;
+} ir_part_t;
+
+/**
+ * A command line, in a single block without pointers: this header, the
+ * nodes, the word parts and the string table (NUL-terminated strings). The
+ * root is node 0. The block can be written to a file as it is and read back
+ * on the same kind of machine (check it with ir_valid first).
+ */
+typedef struct {
+  uint32_t magic;
+  uint32_t size;    /* Bytes of the whole block */
+  uint32_t nodes;
+  uint32_t simple;  /* Nodes that are simple commands */
+  uint32_t parts;
+  uint32_t strings; /* Bytes of the string table */
+} ir_t;
+
+#define IR_NODES(ir)   ((const ir_node_t *)((const ir_t *)(ir) + 1))
+#define IR_PARTS(ir)   ((const ir_part_t *)(IR_NODES(ir) + (ir)->nodes))
+#define IR_STRINGS(ir) ((const char *)(IR_PARTS(ir) + (ir)->parts))
+#define IR_STRING(ir, offset) (IR_STRINGS(ir) + (offset))
+
+/**
+ * The compact form of the tree rooted at root (not NULL), in a single
+ * malloc'd block. Words shared by two lists (cmd &> file) are stored once
+ * per list.
+ */
+ir_t *ir_build(command_t *root);
+
+/**
+ * Check that the size bytes at data hold a well-formed block, as built by
+ * ir_build: every index and offset within bounds, nodes linked forward only,
+ * a single word for the verb and for the here-document or here-string.
+ */
+bool ir_valid(const void *data, size_t size);
+
+/**
+ * Bytes needed by ir_thaw.
+ */
+size_t ir_tree_size(const ir_t *ir);
+
+/**
+ * Check whether the command line of ir has a here-document.
+ */
+bool ir_here_docs(const ir_t *ir);
+
+/**
+ * Rebuild the tree of ir in block (ir_tree_size bytes, aligned for
+ * pointers): its nodes, in the order of ir, and then its strings. The tree
+ * does not refer to ir. Returns the root.
+ */
+command_t *ir_thaw(const ir_t *ir, void *block);
+
+#endif
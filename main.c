@@ -6,8 +6,17 @@
  *****************************************************************************/
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include <unistd.h>
+
+#include "cache.h"
+#include "here.h"
+#include "input.h"
+#include "parallel.h"
 #include "parser.h"
+#include "pipeline.h"
+#include "script.h"
 #include "utils.h"
 
 #define PROMPT "> "
@@ -16,30 +25,35 @@ void parse_error(const char *str, const int where) {
   fprintf(stderr, "Parse error near %d: %s\n", where, str);
 }
 
-void start_shell() {
-  char *line;
+void start_shell(bool batch) {
+  const char *line;
+  size_t length;
   command_t *root;
 
   int ret;
 
   for(;;) {
-    printf(PROMPT);
-    fflush(stdout);
+    if (!batch) {
+      printf(PROMPT);
+      fflush(stdout);
+    }
     ret = 0;
 
-    root = NULL;
-    line = read_line();
+    line = read_line(&length);
     if (line == NULL) {
       return;
     }
-    parse_line(line, &root);
+    root = cache_parse(line, length);
+    if (root != NULL && here_docs(root)) {
+      here_read(root);
+    }
 
     if (root != NULL) {
       ret = parse_command(root, 0, NULL);
     }
 
+    cache_release(root);
     free_parse_memory();
-    free(line);
 
     if (ret == SHELL_EXIT) {
       break;
@@ -47,8 +61,46 @@ void start_shell() {
   }
 }
 
-int main(void) {
-  start_shell();
+int main(int argc, char *argv[]) {
+  bool batch = false;
+  int opt;
+
+  /* mini-shell [-j jobs] [-p pipe-size] [script] */
+  while ((opt = getopt(argc, argv, "+j:p:")) != -1) {
+    if (opt == 'j') {
+      char *end;
+      long jobs = strtol(optarg, &end, 10);
+      if (*optarg == 0 || *end != 0 || jobs < 0) {
+        fprintf(stderr, "%s: invalid number of jobs '%s'\n", argv[0], optarg);
+        return EXIT_FAILURE;
+      }
+      parallel_set_jobs((int)jobs);
+    } else if (opt == 'p') {
+      int size = pipeline_parse_size(optarg);
+      if (size == 0 && strcmp(optarg, "0") != 0) {
+        fprintf(stderr, "%s: invalid pipe size '%s'\n", argv[0], optarg);
+        return EXIT_FAILURE;
+      }
+      pipeline_set_pipe_size(size);
+    } else {
+      fprintf(stderr, "Usage: %s [-j jobs] [-p pipe-size] [script]\n",
+              argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
 
-  return EXIT_SUCCESS;
-}
\ No newline at end of file
+  /* mini-shell script: run the script, without prompting */
+  if (optind < argc) {
+    if (input_open(argv[optind]) != 0) {
+      perror(argv[optind]);
+      return EXIT_FAILURE;
+    }
+    script_open(argv[optind]);
+    batch = true;
+  }
+
+  start_shell(batch);
+  script_close();
+
+  return last_status;
+}
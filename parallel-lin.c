@@ -0,0 +1,119 @@
+/******************************************************************************
+ * Mini Shell in Linux - parallel commands implementation
+ *****************************************************************************/
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <unistd.h>
+
+#include "minternals.h"
+#include "parallel.h"
+#include "utils.h"
+
+
+
+/* Declarations */
+static int  count_branches(command_t *c);
+static void add_branches  (command_t *c, parallel_t *p);
+static int  resolve_jobs  (int jobs);
+
+static bool jobs_set;
+static int  jobs_option;
+
+
+
+/**
+ * Limit the number of branches of a parallel chain that run at once.
+ */
+void parallel_set_jobs(int jobs) {
+  jobs_set = true;
+  jobs_option = jobs;
+}
+
+/**
+ * The number of branches that may run at the same time.
+ */
+int parallel_jobs() {
+  if (jobs_set) {
+    return resolve_jobs(jobs_option);
+  }
+
+  /* Read at every chain, so that the shell itself may change it */
+  const char *value = getenv(PARALLEL_JOBS_VAR);
+  if (value == NULL || *value == 0) {
+    return INT_MAX;
+  }
+
+  char *end;
+  long jobs = strtol(value, &end, 10);
+  if (*end != 0 || jobs < 0 || jobs > INT_MAX) {
+    return INT_MAX;
+  }
+
+  return resolve_jobs((int)jobs);
+}
+
+/**
+ * Collect the branches of the parallel chain rooted at c.
+ */
+void parallel_collect(command_t *c, parallel_t *p) {
+  p->branches = calloc(count_branches(c), sizeof(command_t *));
+  if (p->branches == NULL) {
+    mfatal(ERR_ALLOCATION);
+  }
+  p->count = 0;
+
+  add_branches(c, p);
+}
+
+/**
+ * Release the memory held by p (not the branches themselves).
+ */
+void parallel_free(parallel_t *p) {
+  free(p->branches);
+  p->branches = NULL;
+  p->count = 0;
+}
+
+
+
+/**
+ * Number of branches of the parallel chain rooted at c.
+ */
+static int count_branches(command_t *c) {
+  if (c->op != OP_PARALLEL) {
+    return 1;
+  }
+  return count_branches(c->cmd1) + count_branches(c->cmd2);
+}
+
+/**
+ * Append the branches of c to p, in the order they appear in the command
+ * line.
+ */
+static void add_branches(command_t *c, parallel_t *p) {
+  if (c->op != OP_PARALLEL) {
+    p->branches[p->count++] = c;
+    return;
+  }
+  add_branches(c->cmd1, p);
+  add_branches(c->cmd2, p);
+}
+
+/**
+ * Turn a -j value into a number of branches.
+ */
+static int resolve_jobs(int jobs) {
+  if (jobs < 0) {
+    return INT_MAX;
+  }
+
+  if (jobs == 0) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (int)cpus : 1;
+  }
+
+  return jobs;
+}
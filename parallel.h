@@ -0,0 +1,47 @@
+/******************************************************************************
+ * Mini Shell in Linux - parallel commands
+ *****************************************************************************/
+
+#ifndef _PARALLEL_H
+#define _PARALLEL_H
+
+#include "parser.h"
+
+/**
+ * A chain of OP_PARALLEL nodes (cmd1 & cmd2 & ... & cmdN) flattened into its
+ * branches, left to right. A branch is never an OP_PARALLEL node; since &
+ * binds weaker than &&, || and |, it is a simple command, a pipe chain or a
+ * conditional chain.
+ */
+typedef struct {
+  command_t **branches;
+  int count;
+} parallel_t;
+
+/* Environment variable holding the maximum number of branches run at once */
+#define PARALLEL_JOBS_VAR "MINISHELL_JOBS"
+
+/**
+ * Limit the number of branches of a parallel chain that run at the same time
+ * (mini-shell -j jobs); the others wait in a run queue for one to end. 0
+ * means the number of online CPUs, -1 no limit. Without this call the limit
+ * comes from PARALLEL_JOBS_VAR, and there is none when it is not set.
+ */
+void parallel_set_jobs(int jobs);
+
+/**
+ * The number of branches that may run at the same time (at least 1).
+ */
+int parallel_jobs();
+
+/**
+ * Collect the branches of the parallel chain rooted at c.
+ */
+void parallel_collect(command_t *c, parallel_t *p);
+
+/**
+ * Release the memory held by p (not the branches themselves).
+ */
+void parallel_free(parallel_t *p);
+
+#endif
@@ -95,6 +95,12 @@ typedef struct word_t {
  any of these lists, the literals are in the original order.
 
  io_flags is used to specify special modes for redirection (e.g. appending)
+
+ here is the word of a here-document (cmd << delimiter, IO_HERE_DOC set in
+ io_flags) or of a here-string (cmd <<< word, IO_HERE_STRING set), NULL
+ otherwise; a command has at most one of them. The text of a here-document
+ comes from the lines that follow the command line, up to the delimiter:
+ the parser does not read it, here_doc is NULL until the shell fills it in.
  
  Some string literals can be found in both the out list and the err list
  (those entered as "command &> out").
@@ -106,6 +112,8 @@ typedef struct word_t {
 #define IO_REGULAR	0x00
 #define IO_OUT_APPEND	0x01
 #define IO_ERR_APPEND	0x02
+#define IO_HERE_DOC	0x04
+#define IO_HERE_STRING	0x08
 
 typedef struct {
 	word_t * verb;
@@ -113,6 +121,8 @@ typedef struct {
 	word_t * in;
 	word_t * out;
 	word_t * err;
+	word_t * here;
+	const char * here_doc;
 	int io_flags;
 	struct command_t * up;
 	void * aux;
@@ -178,6 +188,9 @@ typedef struct command_t {
 } command_t;
 
 
+#include <stddef.h>
+
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -212,6 +225,15 @@ void parse_error(const char * str, const int where);
 bool parse_line(const char * line, command_t ** root);
 
 
+/*
+ same as parse_line, but line points to length bytes that need not be
+ followed by '\0' (e.g. a line inside a bigger buffer); the bytes are
+ not modified
+*/
+
+bool parse_line_n(const char * line, size_t length, command_t ** root);
+
+
 /*
  should be called to free the parse tree
  call this even if parse_line() returned false
@@ -219,6 +241,15 @@ bool parse_line(const char * line, command_t ** root);
 
 void free_parse_memory();
 
+
+/*
+ copy length bytes of str (and a terminating '\0') into the memory of the
+ parse tree; the copy is freed along with the tree by free_parse_memory(),
+ even when the tree itself did not come from the parser
+*/
+
+char * parserStrndup(const char * str, size_t length);
+
 #ifdef __cplusplus
 }
 #endif
@@ -230,25 +261,56 @@ void free_parse_memory();
  parser and lexer common internal stuff
 */
 
-typedef void * GenericPointer;
+/*
+ a list of words (linked by next_word) or of the parts of a word (linked
+ by next_part) being built; last points to the last element, so that
+ appending does not walk the whole list
+*/
+
+typedef struct {
+	word_t * first;
+	word_t * last;
+} word_list_t;
 
 typedef struct {
-	word_t * red_i;
-	word_t * red_o;
-	word_t * red_e;
+	word_list_t red_i;
+	word_list_t red_o;
+	word_list_t red_e;
+	word_t * red_here;
 	int red_flags;
 } redirect_t;
 
 
+/*
+ the state of the lexer (parser.lex.c) scanning the bytes from start to
+ end; pos points to the next byte to scan
+
+ only the scanning state is here: the strings of the tokens, and the
+ tree built from them, come from the global parse arena (parserAlloc),
+ so a lexer_t does not make parsing re-entrant
+*/
+
+typedef enum {
+	LEXER_UNQUOTED,
+	LEXER_SINGLE_QUOTED,
+	LEXER_DOUBLE_QUOTED
+} lexer_state_t;
+
+typedef struct {
+	const char * start;
+	const char * pos;
+	const char * end;
+	lexer_state_t state;
+} lexer_t;
+
+
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
-int yylex();
-void globalParseAnotherString(const char * str);
-void globalEndParsing();
-void pointerToMallocMemory(const void * ptr);
+void lexerStart(lexer_t * lexer, const char * str, size_t length);
+void * parserAlloc(size_t size);
 
 #ifdef __cplusplus
 }
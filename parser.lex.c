@@ -0,0 +1,416 @@
+/*
+ hand-written scanner for the grammar in parser.y
+
+ it works directly on the bytes given to parse_line_n (no copy of the
+ line is made) and keeps its scanning state in a lexer_t instead of
+ globals; it is not allocation-free, though: the string of every WORD
+ and ENV_VAR token is copied into the parse arena, which is global and
+ rewound by each parse_line_n, so only one line is parsed at a time
+
+ the tokens are the ones the former flex scanner (parser.l) returned,
+ plus HERE_DOC (<<), HERE_STRING (<<<) and the special parameter $?
+ (an ENV_VAR named "?")
+*/
+
+
+#ifdef __cplusplus
+
+#include <cstring>
+
+using namespace std;
+
+#else
+
+#include <string.h>
+
+#endif
+
+/*
+ on x86-64 the runs of WORD bytes are scanned 16 (SSE2) or, when the
+ processor has it, 32 (AVX2) bytes at a time; define LEXER_NO_SIMD to
+ scan them a byte at a time, or LEXER_NO_AVX2 to stop at SSE2
+*/
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(LEXER_NO_SIMD)
+#  define LEXER_SIMD
+#  include <immintrin.h>
+#  if !defined(LEXER_NO_AVX2)
+#    define LEXER_AVX2
+#  endif
+#endif
+
+#define __PARSER_H_INTERNAL_INCLUDE
+#include "parser.h"
+#include "parser.tab.h"
+
+
+/*
+ the classes of a byte; one byte can be in several of them
+*/
+
+#define CLASS_WORD		0x01	/* part of a WORD: [a-zA-Z0-9\-\\+:._%?*~/,] */
+#define CLASS_NAME		0x02	/* part of a variable name: [a-zA-Z0-9_] */
+#define CLASS_NAME_START	0x04	/* first byte of a variable name: [a-zA-Z_] */
+#define CLASS_BLANK		0x08	/* [ \t] */
+
+/* returned when a quote only switches the lexer state */
+#define NO_TOKEN	(-1)
+
+
+/* bytes from 0x80 up belong to no class */
+static const unsigned char byteClass[256] = {
+	/* 00 */ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	/* 10 */ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	/* 20 */ 0x08, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+	/* 30 */ 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 0x01,
+	/* 40 */ 0x00, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07,
+	/* 50 */ 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x00, 0x01, 0x00, 0x00, 0x07,
+	/* 60 */ 0x00, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07,
+	/* 70 */ 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x00, 0x00, 0x00, 0x01, 0x00,
+};
+
+#define IS(c, class)	((byteClass[(unsigned char)(c)] & (class)) != 0)
+
+
+/*
+ the end of the run of WORD bytes that starts at p (and stops at end, at
+ the latest)
+*/
+static const char * wordEndScalar(const char * p, const char * end)
+{
+	while (p < end && IS(*p, CLASS_WORD))
+		p++;
+
+	return p;
+}
+
+
+#ifdef LEXER_SIMD
+
+/*
+ the same, a vector at a time: the WORD bytes are the ranges [a-zA-Z]
+ (a-z once 0x20 is or-ed in) and [*+,-./0-9:], plus % ? \ _ ~; the
+ first byte of a vector that is in none of them ends the run
+ x is in [lo, hi] when x - lo (wrapping around) is at most hi - lo,
+ compared as unsigned: that is, when min(x - lo, hi - lo) == x - lo
+*/
+
+static inline __m128i inRange16(__m128i c, char lo, char hi)
+{
+	__m128i d = _mm_sub_epi8(c, _mm_set1_epi8(lo));
+
+	return _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8((char)(hi - lo))), d);
+}
+
+
+static const char * wordEndSSE2(const char * p, const char * end)
+{
+	while (end - p >= 16) {
+		__m128i c = _mm_loadu_si128((const __m128i *)p);
+		__m128i word = _mm_or_si128(
+			_mm_or_si128(
+				inRange16(_mm_or_si128(c, _mm_set1_epi8(0x20)), 'a', 'z'),
+				inRange16(c, '*', ':')),
+			_mm_or_si128(
+				_mm_or_si128(
+					_mm_cmpeq_epi8(c, _mm_set1_epi8('%')),
+					_mm_cmpeq_epi8(c, _mm_set1_epi8('?'))),
+				_mm_or_si128(
+					_mm_or_si128(
+						_mm_cmpeq_epi8(c, _mm_set1_epi8('\\')),
+						_mm_cmpeq_epi8(c, _mm_set1_epi8('_'))),
+					_mm_cmpeq_epi8(c, _mm_set1_epi8('~')))));
+		unsigned int others = ~(unsigned int)_mm_movemask_epi8(word) & 0xffff;
+
+		if (others != 0)
+			return p + __builtin_ctz(others);
+		p += 16;
+	}
+
+	return wordEndScalar(p, end);
+}
+
+
+#ifdef LEXER_AVX2
+
+__attribute__((target("avx2")))
+static inline __m256i inRange32(__m256i c, char lo, char hi)
+{
+	__m256i d = _mm256_sub_epi8(c, _mm256_set1_epi8(lo));
+
+	return _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8((char)(hi - lo))), d);
+}
+
+
+__attribute__((target("avx2")))
+static const char * wordEndAVX2(const char * p, const char * end)
+{
+	while (end - p >= 32) {
+		__m256i c = _mm256_loadu_si256((const __m256i *)p);
+		__m256i word = _mm256_or_si256(
+			_mm256_or_si256(
+				inRange32(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), 'a', 'z'),
+				inRange32(c, '*', ':')),
+			_mm256_or_si256(
+				_mm256_or_si256(
+					_mm256_cmpeq_epi8(c, _mm256_set1_epi8('%')),
+					_mm256_cmpeq_epi8(c, _mm256_set1_epi8('?'))),
+				_mm256_or_si256(
+					_mm256_or_si256(
+						_mm256_cmpeq_epi8(c, _mm256_set1_epi8('\\')),
+						_mm256_cmpeq_epi8(c, _mm256_set1_epi8('_'))),
+					_mm256_cmpeq_epi8(c, _mm256_set1_epi8('~')))));
+		unsigned int others = ~(unsigned int)_mm256_movemask_epi8(word);
+
+		if (others != 0)
+			return p + __builtin_ctz(others);
+		p += 32;
+	}
+
+	return wordEndSSE2(p, end);
+}
+
+#endif
+
+
+/*
+ the first call picks the widest scan the processor can run; picking it
+ again (from another lexer) gives the same result
+*/
+static const char * wordEndFirst(const char * p, const char * end);
+
+static const char * (*wordEnd)(const char * p, const char * end) = wordEndFirst;
+
+static const char * wordEndFirst(const char * p, const char * end)
+{
+	wordEnd = wordEndSSE2;
+#ifdef LEXER_AVX2
+	if (__builtin_cpu_supports("avx2"))
+		wordEnd = wordEndAVX2;
+#endif
+
+	return wordEnd(p, end);
+}
+
+#else
+
+#define wordEnd wordEndScalar
+
+#endif
+
+
+void lexerStart(lexer_t * lexer, const char * str, size_t length)
+{
+	lexer->start = str;
+	lexer->pos = str;
+	lexer->end = str + length;
+	lexer->state = LEXER_UNQUOTED;
+}
+
+
+/*
+ the token that ends at to; the location of a token is given, as columns,
+ by its first byte and the byte after it
+*/
+static int token(lexer_t * lexer, YYLTYPE * llocp, const char * to, int tok)
+{
+	llocp->first_column = (int)(lexer->pos - lexer->start);
+	llocp->last_column = (int)(to - lexer->start);
+	lexer->pos = to;
+
+	return tok;
+}
+
+
+/*
+ same as token, for a token with a string: the bytes from from to to
+*/
+static int stringToken(lexer_t * lexer, YYSTYPE * lvalp, YYLTYPE * llocp,
+		const char * from, const char * to, int tok)
+{
+	lvalp->string_un = parserStrndup(from, to - from);
+
+	return token(lexer, llocp, to, tok);
+}
+
+
+/*
+ $name, $? or a lone $; p points to the $
+*/
+static int variable(lexer_t * lexer, YYSTYPE * lvalp, YYLTYPE * llocp, const char * p)
+{
+	const char * q = p + 1;
+
+	if (q < lexer->end && *q == '?')
+		return stringToken(lexer, lvalp, llocp, q, q + 1, ENV_VAR);
+
+	if (q == lexer->end || !IS(*q, CLASS_NAME_START))
+		return token(lexer, llocp, q, INVALID_ENVIRONMENT_VAR);
+
+	while (q < lexer->end && IS(*q, CLASS_NAME))
+		q++;
+
+	return stringToken(lexer, lvalp, llocp, p + 1, q, ENV_VAR);
+}
+
+
+static int unquoted(lexer_t * lexer, YYSTYPE * lvalp, YYLTYPE * llocp)
+{
+	const char * p = lexer->pos;
+	const char * end = lexer->end;
+	const char * q = p + 1;
+
+	if (p == end)
+		return END_OF_FILE;
+
+	switch (*p) {
+	case '\r':
+		if (q == end || *q != '\n')
+			return token(lexer, llocp, q, NOT_ACCEPTED_CHAR);
+		q++;
+		/* fall through */
+	case '\n':
+		if (q < end)
+			return token(lexer, llocp, q + 1, CHARS_AFTER_EOL);
+		return token(lexer, llocp, q, END_OF_LINE);
+
+	case '\'':
+		lexer->state = LEXER_SINGLE_QUOTED;
+		return token(lexer, llocp, q, NO_TOKEN);
+
+	case '"':
+		lexer->state = LEXER_DOUBLE_QUOTED;
+		return token(lexer, llocp, q, NO_TOKEN);
+
+	case ';':
+		return token(lexer, llocp, q, SEQUENTIAL);
+
+	case '|':
+		if (q < end && *q == '|')
+			return token(lexer, llocp, q + 1, CONDITIONAL_NZERO);
+		return token(lexer, llocp, q, PIPE);
+
+	case '&':
+		if (q < end && *q == '&')
+			return token(lexer, llocp, q + 1, CONDITIONAL_ZERO);
+		if (q < end && *q == '>')
+			return token(lexer, llocp, q + 1, REDIRECT_OE);
+		return token(lexer, llocp, q, PARALLEL);
+
+	case '2':
+		/*
+		 2> and 2>>; any other 2 starts a WORD, and so does a 2 right
+		 after $? (as in $?2>file, which is $?2 and >file)
+		*/
+		if (q == end || *q != '>')
+			break;
+		if (p - lexer->start >= 2 && p[-1] == '?' && p[-2] == '$')
+			break;
+		q++;
+		if (q < end && *q == '>')
+			return token(lexer, llocp, q + 1, REDIRECT_APPEND_E);
+		return token(lexer, llocp, q, REDIRECT_E);
+
+	case '>':
+		if (q < end && *q == '>')
+			return token(lexer, llocp, q + 1, REDIRECT_APPEND_O);
+		return token(lexer, llocp, q, REDIRECT_O);
+
+	case '<':
+		if (q == end || *q != '<')
+			return token(lexer, llocp, q, INDIRECT);
+		q++;
+		if (q < end && *q == '<')
+			return token(lexer, llocp, q + 1, HERE_STRING);
+		return token(lexer, llocp, q, HERE_DOC);
+
+	case ' ':
+	case '\t':
+		while (q < end && IS(*q, CLASS_BLANK))
+			q++;
+		return token(lexer, llocp, q, BLANK);
+
+	case '=':
+		/* a WORD of its own, see word_t in parser.h */
+		return stringToken(lexer, lvalp, llocp, p, q, WORD);
+
+	case '$':
+		return variable(lexer, lvalp, llocp, p);
+	}
+
+	if (!IS(*p, CLASS_WORD))
+		return token(lexer, llocp, p + 1, NOT_ACCEPTED_CHAR);
+
+	return stringToken(lexer, lvalp, llocp, p, wordEnd(q, end), WORD);
+}
+
+
+/*
+ inside '...': everything up to the next ' is a WORD
+*/
+static int singleQuoted(lexer_t * lexer, YYSTYPE * lvalp, YYLTYPE * llocp)
+{
+	const char * p = lexer->pos;
+	const char * q;
+
+	if (p == lexer->end)
+		return UNEXPECTED_EOF;
+
+	if (*p == '\'') {
+		lexer->state = LEXER_UNQUOTED;
+		return token(lexer, llocp, p + 1, NO_TOKEN);
+	}
+
+	q = (const char *)memchr(p, '\'', lexer->end - p);
+	if (q == NULL)
+		q = lexer->end;
+
+	return stringToken(lexer, lvalp, llocp, p, q, WORD);
+}
+
+
+/*
+ inside "...": variables, and WORDs in between
+*/
+static int doubleQuoted(lexer_t * lexer, YYSTYPE * lvalp, YYLTYPE * llocp)
+{
+	const char * p = lexer->pos;
+	const char * q = p;
+
+	if (p == lexer->end)
+		return UNEXPECTED_EOF;
+
+	if (*p == '"') {
+		lexer->state = LEXER_UNQUOTED;
+		return token(lexer, llocp, p + 1, NO_TOKEN);
+	}
+
+	if (*p == '$')
+		return variable(lexer, lvalp, llocp, p);
+
+	while (q < lexer->end && *q != '"' && *q != '$')
+		q++;
+
+	return stringToken(lexer, lvalp, llocp, p, q, WORD);
+}
+
+
+int yylex(YYSTYPE * lvalp, YYLTYPE * llocp, lexer_t * lexer)
+{
+	int tok;
+
+	do {
+		switch (lexer->state) {
+		case LEXER_SINGLE_QUOTED:
+			tok = singleQuoted(lexer, lvalp, llocp);
+			break;
+		case LEXER_DOUBLE_QUOTED:
+			tok = doubleQuoted(lexer, lvalp, llocp);
+			break;
+		default:
+			tok = unquoted(lexer, lvalp, llocp);
+			break;
+		}
+	} while (tok == NO_TOKEN);
+
+	return tok;
+}
@@ -1,14 +1,14 @@
-/* A Bison parser, made by GNU Bison 2.3.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
-/* Skeleton implementation for Bison's Yacc-like parsers in C
+/* Bison implementation for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989, 1990, 2000, 2001, 2002, 2003, 2004, 2005, 2006
-   Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
-   This program is free software; you can redistribute it and/or modify
+   This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
-   the Free Software Foundation; either version 2, or (at your option)
-   any later version.
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
 
    This program is distributed in the hope that it will be useful,
    but WITHOUT ANY WARRANTY; without even the implied warranty of
@@ -16,9 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program; if not, write to the Free Software
-   Foundation, Inc., 51 Franklin Street, Fifth Floor,
-   Boston, MA 02110-1301, USA.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -36,6 +34,10 @@
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -43,78 +45,29 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "2.3"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
 
 /* Pure parsers.  */
-#define YYPURE 0
-
-/* Using locations.  */
-#define YYLSP_NEEDED 1
-
-
-
-/* Tokens.  */
-#ifndef YYTOKENTYPE
-# define YYTOKENTYPE
-   /* Put the tokens into the symbol table, so that GDB and other debuggers
-      know about them.  */
-   enum yytokentype {
-     NOT_ACCEPTED_CHAR = 258,
-     INVALID_ENVIRONMENT_VAR = 259,
-     UNEXPECTED_EOF = 260,
-     CHARS_AFTER_EOL = 261,
-     END_OF_FILE = 262,
-     END_OF_LINE = 263,
-     BLANK = 264,
-     REDIRECT_OE = 265,
-     REDIRECT_O = 266,
-     REDIRECT_E = 267,
-     INDIRECT = 268,
-     REDIRECT_APPEND_E = 269,
-     REDIRECT_APPEND_O = 270,
-     WORD = 271,
-     ENV_VAR = 272,
-     SEQUENTIAL = 273,
-     PARALLEL = 274,
-     CONDITIONAL_ZERO = 275,
-     CONDITIONAL_NZERO = 276,
-     PIPE = 277
-   };
-#endif
-/* Tokens.  */
-#define NOT_ACCEPTED_CHAR 258
-#define INVALID_ENVIRONMENT_VAR 259
-#define UNEXPECTED_EOF 260
-#define CHARS_AFTER_EOL 261
-#define END_OF_FILE 262
-#define END_OF_LINE 263
-#define BLANK 264
-#define REDIRECT_OE 265
-#define REDIRECT_O 266
-#define REDIRECT_E 267
-#define INDIRECT 268
-#define REDIRECT_APPEND_E 269
-#define REDIRECT_APPEND_O 270
-#define WORD 271
-#define ENV_VAR 272
-#define SEQUENTIAL 273
-#define PARALLEL 274
-#define CONDITIONAL_ZERO 275
-#define CONDITIONAL_NZERO 276
-#define PIPE 277
+#define YYPURE 2
+
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
 
 
 
 
-/* Copy the first part of user declarations.  */
-#line 4 "parser.y"
+/* First part of user prologue.  */
+#line 7 "parser.y"
 
 
 
@@ -148,74 +101,120 @@ using namespace std;
 #include "parser.h"
 
 
-static GenericPointer * globalAllocMem = NULL;
-static size_t globalAllocCount = 0;
-static size_t globalAllocSize  = 0;
-static bool needsFree = false;
-static command_t * command_root = NULL;
+/*
+ all the memory of a parse (parse tree nodes and token strings) is taken
+ from an arena: a list of blocks that are never freed one by one;
+ free_parse_memory() only rewinds the arena, so the next line reuses
+ the same blocks
+*/
+
+#define ARENA_BLOCK_SIZE	(64 * 1024)
+#define ARENA_ALIGN		(sizeof(void *))
 
+typedef struct arenaBlock {
+	struct arenaBlock * next;
+	size_t size;
+	size_t used;
+} arenaBlock;
 
-void yyerror(const char* str);
+static arenaBlock * arenaFirst = NULL;
+static arenaBlock * arenaCurrent = NULL;
+static bool needsFree = false;
 
 
-static void ensureSize(size_t newSize)
+static char * blockData(arenaBlock * block)
 {
-	GenericPointer * newPtr;
-	assert(newSize > 0);
-
-	if (globalAllocSize == 0) {
-		assert(globalAllocMem == NULL);
-		globalAllocSize = newSize;
-		globalAllocMem = (GenericPointer *)malloc(sizeof(GenericPointer) * globalAllocSize);
-		if (globalAllocMem == NULL) {
-			fprintf(stderr, "malloc() failed\n");
-			exit(EXIT_FAILURE);
-		}
+	/* the data follows the (aligned) header */
+	return (char *)block + ((sizeof(arenaBlock) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1));
+}
 
-		return;
-	}
 
-	assert(globalAllocMem != NULL);
-	if (globalAllocSize >= newSize) {
-		return;
+static arenaBlock * newBlock(size_t size)
+{
+	arenaBlock * block;
+
+	if (size < ARENA_BLOCK_SIZE) {
+		size = ARENA_BLOCK_SIZE;
 	}
 
-	globalAllocSize += newSize;
-	newPtr = (GenericPointer *)realloc((void *)globalAllocMem, sizeof(GenericPointer) * globalAllocSize);
-	if (newPtr == NULL) {
-		fprintf(stderr, "realloc() failed\n");
+	block = (arenaBlock *)malloc((blockData(NULL) - (char *)NULL) + size);
+	if (block == NULL) {
+		fprintf(stderr, "malloc() failed\n");
 		exit(EXIT_FAILURE);
 	}
 
-	globalAllocMem = newPtr;
+	block->next = NULL;
+	block->size = size;
+	block->used = 0;
+
+	return block;
 }
 
 
-void pointerToMallocMemory(const void * ptr)
+void * parserAlloc(size_t size)
 {
-	if (ptr == NULL) {
-		fprintf(stderr, "malloc() failed\n");
-		exit(EXIT_FAILURE);
+	void * ptr;
+	assert(size > 0);
+
+	size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+
+	if (arenaCurrent == NULL) {
+		assert(arenaFirst == NULL);
+		arenaFirst = arenaCurrent = newBlock(size);
+	}
+
+	/* blocks after the current one are left over from a previous parse */
+	while (arenaCurrent->size - arenaCurrent->used < size) {
+		if (arenaCurrent->next == NULL) {
+			arenaCurrent->next = newBlock(size);
+		}
+		arenaCurrent = arenaCurrent->next;
+		arenaCurrent->used = 0;
 	}
 
-	ensureSize(globalAllocCount + 1);
-	globalAllocMem[globalAllocCount++] = (GenericPointer)ptr;
+	ptr = blockData(arenaCurrent) + arenaCurrent->used;
+	arenaCurrent->used += size;
+	/* also when the tree was not parsed (see parserStrndup) */
+	needsFree = true;
+
+	return ptr;
+}
+
+
+char * parserStrndup(const char * str, size_t length)
+{
+	char * copy = (char *)parserAlloc(length + 1);
+
+	memcpy(copy, str, length);
+	copy[length] = '\0';
+
+	return copy;
+}
+
+
+static void arenaReset()
+{
+	if (arenaFirst != NULL) {
+		arenaCurrent = arenaFirst;
+		arenaCurrent->used = 0;
+	}
 }
 
 
 static simple_command_t * bind_parts(word_t * exe_name, word_t * params, redirect_t red)
 {
-	simple_command_t * s = (simple_command_t *) malloc(sizeof(simple_command_t));
-	pointerToMallocMemory(s);
+	simple_command_t * s = (simple_command_t *) parserAlloc(sizeof(simple_command_t));
 
 	memset(s, 0, sizeof(*s));
 	assert(exe_name != NULL);
 	assert(exe_name->next_word == NULL);
 	s->verb = exe_name;
 	s->params = params;
-	s->in = red.red_i;
-	s->out = red.red_o;
-	s->err = red.red_e;
+	s->in = red.red_i.first;
+	s->out = red.red_o.first;
+	s->err = red.red_e.first;
+	s->here = red.red_here;
+	s->here_doc = NULL;
 	s->io_flags = red.red_flags;
 	s->up = NULL;
 	s->aux = NULL;
@@ -225,8 +224,7 @@ static simple_command_t * bind_parts(word_t * exe_name, word_t * params, redirec
 
 static command_t * new_command(simple_command_t * scmd)
 {
-	command_t * c = (command_t *) malloc(sizeof(command_t));
-	pointerToMallocMemory(c);
+	command_t * c = (command_t *) parserAlloc(sizeof(command_t));
 
 	memset(c, 0, sizeof(*c));
 	c->up = c->cmd1 = c->cmd2 = NULL;
@@ -241,8 +239,7 @@ static command_t * new_command(simple_command_t * scmd)
 
 static command_t * bind_commands(command_t * cmd1, command_t * cmd2, operator_t op)
 {
-	command_t * c = (command_t *) malloc(sizeof(command_t));
-	pointerToMallocMemory(c);
+	command_t * c = (command_t *) parserAlloc(sizeof(command_t));
 
 	memset(c, 0, sizeof(*c));
 	c->up = NULL;
@@ -266,8 +263,7 @@ static command_t * bind_commands(command_t * cmd1, command_t * cmd2, operator_t
 
 static word_t * new_word(const char * str, bool expand)
 {
-	word_t * w = (word_t *) malloc(sizeof(word_t));
-	pointerToMallocMemory(w);
+	word_t * w = (word_t *) parserAlloc(sizeof(word_t));
 
 	memset(w, 0, sizeof(*w));
 	assert(str != NULL);
@@ -280,24 +276,25 @@ static word_t * new_word(const char * str, bool expand)
 }
 
 
-static word_t * add_part_to_word(word_t * w, word_t * lst)
+static word_list_t new_list(word_t * w)
 {
-	word_t * crt = lst;
-	assert(lst != NULL);
-	assert(w != NULL);
+	word_list_t lst;
 
-	/*
-	 we could insert at the beginnig and then invert the list
-	 but this would make the code a bit more complicated
-	 thus, we assume we have small lists and O(n*n) is acceptable
-	*/
+	lst.first = w;
+	lst.last = w;
 
-	while (crt->next_part != NULL) {
-		crt = crt->next_part;
-		assert((crt == NULL) || (crt->next_word == NULL));
-	}
+	return lst;
+}
 
-	crt->next_part = w;
+
+static word_list_t add_part_to_word(word_t * w, word_list_t lst)
+{
+	assert(lst.last != NULL);
+	assert(lst.last->next_part == NULL);
+	assert(w != NULL);
+
+	lst.last->next_part = w;
+	lst.last = w;
 	assert(w->next_part == NULL);
 	assert(w->next_word == NULL);
 
@@ -305,120 +302,222 @@ static word_t * add_part_to_word(word_t * w, word_t * lst)
 }
 
 
-static word_t * add_word_to_list(word_t * w, word_t * lst)
+static word_list_t add_word_to_list(word_t * w, word_list_t lst)
 {
-	word_t * crt = lst;
 	assert(w != NULL);
 
-	if (crt == NULL) {
+	if (lst.first == NULL) {
 		assert(w->next_word == NULL);
-		return w;
+		return new_list(w);
 	}
-	assert(lst != NULL);
+	assert(lst.last != NULL);
 
 	/*
-	 same as above
+	 the word after &> is on both the red_o and the red_e lists, so
+	 appending to one list appends to the other one too; the last word
+	 is not always the last one then, but it is on the list, before the
+	 words appended since
 	*/
-	while (crt->next_word != NULL) {
-		crt = crt->next_word;
+	while (lst.last->next_word != NULL) {
+		lst.last = lst.last->next_word;
 	}
 
-	crt->next_word = w;
+	lst.last->next_word = w;
+	lst.last = w;
 	assert(w->next_word == NULL);
 
 	return lst;
 }
 
 
+/*
+ adds w to the input redirections of red: a file (kind IO_REGULAR), the
+ delimiter of a here-document (IO_HERE_DOC) or a here-string
+ (IO_HERE_STRING)
+ returns false (after reporting the error, found at column where) for a
+ second here-document or here-string, which the shell would not know
+ where to read from
+*/
+static bool add_input(word_t * w, int kind, redirect_t * red, int where)
+{
+	if (kind == IO_REGULAR) {
+		red->red_i = add_word_to_list(w, red->red_i);
+		return true;
+	}
+
+	if (red->red_here != NULL) {
+		parse_error("more than one here-document or here-string", where);
+		return false;
+	}
 
+	red->red_here = w;
+	red->red_flags |= kind;
+	return true;
+}
 
-/* Enabling traces.  */
-#ifndef YYDEBUG
-# define YYDEBUG 0
-#endif
 
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 1
-#endif
 
-/* Enabling the token table.  */
-#ifndef YYTOKEN_TABLE
-# define YYTOKEN_TABLE 0
-#endif
+#line 361 "parser.tab.c"
 
-#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE
-#line 221 "parser.y"
-{
-	command_t * command_un;
-	const char * string_un;
-	redirect_t redirect_un;
-	simple_command_t * simple_command_un;
-	word_t * exe_un;
-	word_t * params_un;
-	word_t * word_un;
-}
-/* Line 187 of yacc.c.  */
-#line 367 "parser.tab.c"
-	YYSTYPE;
-# define yystype YYSTYPE /* obsolescent; will be withdrawn */
-# define YYSTYPE_IS_DECLARED 1
-# define YYSTYPE_IS_TRIVIAL 1
-#endif
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
 
-#if ! defined YYLTYPE && ! defined YYLTYPE_IS_DECLARED
-typedef struct YYLTYPE
+#include "parser.tab.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
 {
-  int first_line;
-  int first_column;
-  int last_line;
-  int last_column;
-} YYLTYPE;
-# define yyltype YYLTYPE /* obsolescent; will be withdrawn */
-# define YYLTYPE_IS_DECLARED 1
-# define YYLTYPE_IS_TRIVIAL 1
-#endif
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_NOT_ACCEPTED_CHAR = 3,          /* NOT_ACCEPTED_CHAR  */
+  YYSYMBOL_INVALID_ENVIRONMENT_VAR = 4,    /* INVALID_ENVIRONMENT_VAR  */
+  YYSYMBOL_UNEXPECTED_EOF = 5,             /* UNEXPECTED_EOF  */
+  YYSYMBOL_CHARS_AFTER_EOL = 6,            /* CHARS_AFTER_EOL  */
+  YYSYMBOL_END_OF_FILE = 7,                /* END_OF_FILE  */
+  YYSYMBOL_END_OF_LINE = 8,                /* END_OF_LINE  */
+  YYSYMBOL_BLANK = 9,                      /* BLANK  */
+  YYSYMBOL_REDIRECT_OE = 10,               /* REDIRECT_OE  */
+  YYSYMBOL_REDIRECT_O = 11,                /* REDIRECT_O  */
+  YYSYMBOL_REDIRECT_E = 12,                /* REDIRECT_E  */
+  YYSYMBOL_INDIRECT = 13,                  /* INDIRECT  */
+  YYSYMBOL_HERE_DOC = 14,                  /* HERE_DOC  */
+  YYSYMBOL_HERE_STRING = 15,               /* HERE_STRING  */
+  YYSYMBOL_REDIRECT_APPEND_E = 16,         /* REDIRECT_APPEND_E  */
+  YYSYMBOL_REDIRECT_APPEND_O = 17,         /* REDIRECT_APPEND_O  */
+  YYSYMBOL_WORD = 18,                      /* WORD  */
+  YYSYMBOL_ENV_VAR = 19,                   /* ENV_VAR  */
+  YYSYMBOL_SEQUENTIAL = 20,                /* SEQUENTIAL  */
+  YYSYMBOL_PARALLEL = 21,                  /* PARALLEL  */
+  YYSYMBOL_CONDITIONAL_NZERO = 22,         /* CONDITIONAL_NZERO  */
+  YYSYMBOL_CONDITIONAL_ZERO = 23,          /* CONDITIONAL_ZERO  */
+  YYSYMBOL_PIPE = 24,                      /* PIPE  */
+  YYSYMBOL_YYACCEPT = 25,                  /* $accept  */
+  YYSYMBOL_command_tree = 26,              /* command_tree  */
+  YYSYMBOL_command = 27,                   /* command  */
+  YYSYMBOL_simple_command = 28,            /* simple_command  */
+  YYSYMBOL_exe_name = 29,                  /* exe_name  */
+  YYSYMBOL_params = 30,                    /* params  */
+  YYSYMBOL_redirect = 31,                  /* redirect  */
+  YYSYMBOL_indirect = 32,                  /* indirect  */
+  YYSYMBOL_word = 33                       /* word  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
 
 
-/* Copy the second part of user declarations.  */
 
+/* Unqualified %code blocks.  */
+#line 304 "parser.y"
 
-/* Line 216 of yacc.c.  */
-#line 392 "parser.tab.c"
+
+void yyerror(YYLTYPE * llocp, lexer_t * lexer, command_t ** root, const char * str);
+
+
+#line 435 "parser.tab.c"
 
 #ifdef short
 # undef short
 #endif
 
-#ifdef YYTYPE_UINT8
-typedef YYTYPE_UINT8 yytype_uint8;
-#else
-typedef unsigned char yytype_uint8;
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
 #endif
 
-#ifdef YYTYPE_INT8
-typedef YYTYPE_INT8 yytype_int8;
-#elif (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
 typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
 #else
-typedef short int yytype_int8;
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
 #endif
 
-#ifdef YYTYPE_UINT16
-typedef YYTYPE_UINT16 yytype_uint16;
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
 #else
-typedef unsigned short int yytype_uint16;
+typedef short yytype_uint8;
 #endif
 
-#ifdef YYTYPE_INT16
-typedef YYTYPE_INT16 yytype_int16;
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
 #else
-typedef short int yytype_int16;
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
 #endif
 
 #ifndef YYSIZE_T
@@ -426,55 +525,106 @@ typedef short int yytype_int16;
 #  define YYSIZE_T __SIZE_TYPE__
 # elif defined size_t
 #  define YYSIZE_T size_t
-# elif ! defined YYSIZE_T && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
 #  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
 #  define YYSIZE_T size_t
 # else
-#  define YYSIZE_T unsigned int
+#  define YYSIZE_T unsigned
 # endif
 #endif
 
-#define YYSIZE_MAXIMUM ((YYSIZE_T) -1)
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
 
 #ifndef YY_
-# if YYENABLE_NLS
+# if defined YYENABLE_NLS && YYENABLE_NLS
 #  if ENABLE_NLS
 #   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
-#   define YY_(msgid) dgettext ("bison-runtime", msgid)
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
 #  endif
 # endif
 # ifndef YY_
-#  define YY_(msgid) msgid
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
 # endif
 #endif
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(e) ((void) (e))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(e) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-/* Identity function, used to suppress warnings about constant conditions.  */
-#ifndef lint
-# define YYID(n) (n)
-#else
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static int
-YYID (int i)
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
 #else
-static int
-YYID (i)
-    int i;
+# define YY_INITIAL_VALUE(Value) Value
 #endif
-{
-  return i;
-}
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
 #endif
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if 1
 
 /* The parser invokes alloca or malloc; define the necessary symbols.  */
 
@@ -491,11 +641,11 @@ YYID (i)
 #    define alloca _alloca
 #   else
 #    define YYSTACK_ALLOC alloca
-#    if ! defined _ALLOCA_H && ! defined _STDLIB_H && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
 #     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
-#     ifndef _STDLIB_H
-#      define _STDLIB_H 1
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
 #     endif
 #    endif
 #   endif
@@ -503,8 +653,8 @@ YYID (i)
 # endif
 
 # ifdef YYSTACK_ALLOC
-   /* Pacify GCC's `empty if-body' warning.  */
-#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (YYID (0))
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
 #  ifndef YYSTACK_ALLOC_MAXIMUM
     /* The OS might guarantee only one guard page at the bottom of the stack,
        and a page size can be as small as 4096 bytes.  So we cannot safely
@@ -518,113 +668,120 @@ YYID (i)
 #  ifndef YYSTACK_ALLOC_MAXIMUM
 #   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
 #  endif
-#  if (defined __cplusplus && ! defined _STDLIB_H \
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
        && ! ((defined YYMALLOC || defined malloc) \
-	     && (defined YYFREE || defined free)))
+             && (defined YYFREE || defined free)))
 #   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
-#   ifndef _STDLIB_H
-#    define _STDLIB_H 1
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
 #   endif
 #  endif
 #  ifndef YYMALLOC
 #   define YYMALLOC malloc
-#   if ! defined malloc && ! defined _STDLIB_H && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#   if ! defined malloc && ! defined EXIT_SUCCESS
 void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 #  ifndef YYFREE
 #   define YYFREE free
-#   if ! defined free && ! defined _STDLIB_H && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#   if ! defined free && ! defined EXIT_SUCCESS
 void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* 1 */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
-	 || (defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL \
-	     && defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+         || (defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL \
+             && defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
 
 /* A type that is properly aligned for any stack member.  */
 union yyalloc
 {
-  yytype_int16 yyss;
-  YYSTYPE yyvs;
-    YYLTYPE yyls;
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+  YYLTYPE yyls_alloc;
 };
 
 /* The size of the maximum gap between one aligned stack and the next.  */
-# define YYSTACK_GAP_MAXIMUM (sizeof (union yyalloc) - 1)
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
 
 /* The size of an array large to enough to hold all stacks, each with
    N elements.  */
 # define YYSTACK_BYTES(N) \
-     ((N) * (sizeof (yytype_int16) + sizeof (YYSTYPE) + sizeof (YYLTYPE)) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE) \
+             + YYSIZEOF (YYLTYPE)) \
       + 2 * YYSTACK_GAP_MAXIMUM)
 
-/* Copy COUNT objects from FROM to TO.  The source and destination do
-   not overlap.  */
-# ifndef YYCOPY
-#  if defined __GNUC__ && 1 < __GNUC__
-#   define YYCOPY(To, From, Count) \
-      __builtin_memcpy (To, From, (Count) * sizeof (*(From)))
-#  else
-#   define YYCOPY(To, From, Count)		\
-      do					\
-	{					\
-	  YYSIZE_T yyi;				\
-	  for (yyi = 0; yyi < (Count); yyi++)	\
-	    (To)[yyi] = (From)[yyi];		\
-	}					\
-      while (YYID (0))
-#  endif
-# endif
+# define YYCOPY_NEEDED 1
 
 /* Relocate STACK from its old location to the new one.  The
    local variables YYSIZE and YYSTACKSIZE give the old and new number of
    elements in the stack, and YYPTR gives the new location of the
    stack.  Advance YYPTR to a properly aligned location for the next
    stack.  */
-# define YYSTACK_RELOCATE(Stack)					\
-    do									\
-      {									\
-	YYSIZE_T yynewbytes;						\
-	YYCOPY (&yyptr->Stack, Stack, yysize);				\
-	Stack = &yyptr->Stack;						\
-	yynewbytes = yystacksize * sizeof (*Stack) + YYSTACK_GAP_MAXIMUM; \
-	yyptr += yynewbytes / sizeof (*yyptr);				\
-      }									\
-    while (YYID (0))
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
 
 #endif
 
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
 /* YYFINAL -- State number of the termination state.  */
 #define YYFINAL  14
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   130
+#define YYLAST   136
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  23
+#define YYNTOKENS  25
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  8
+#define YYNNTS  9
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  50
-/* YYNRULES -- Number of states.  */
-#define YYNSTATES  75
+#define YYNRULES  53
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  78
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   279
 
-/* YYTRANSLATE(YYLEX) -- Bison symbol number corresponding to YYLEX.  */
-#define YYUNDEFTOK  2
-#define YYMAXUTOK   277
 
-#define YYTRANSLATE(YYX)						\
-  ((unsigned int) (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
 
-/* YYTRANSLATE[YYLEX] -- Bison symbol number corresponding to YYLEX.  */
-static const yytype_uint8 yytranslate[] =
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
 {
        0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -653,294 +810,238 @@ static const yytype_uint8 yytranslate[] =
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
        5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
-      15,    16,    17,    18,    19,    20,    21,    22
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    24
 };
 
 #if YYDEBUG
-/* YYPRHS[YYN] -- Index of the first RHS symbol of rule number YYN in
-   YYRHS.  */
-static const yytype_uint8 yyprhs[] =
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
 {
-       0,     0,     3,     6,     9,    11,    13,    16,    19,    21,
-      25,    29,    33,    37,    41,    46,    52,    55,    59,    61,
-      64,    68,    70,    71,    75,    79,    83,    87,    91,    95,
-     100,   105,   110,   115,   120,   125,   130,   135,   140,   145,
-     150,   155,   161,   167,   173,   179,   185,   191,   194,   197,
-     199
+       0,   353,   353,   358,   363,   368,   373,   378,   387,   391,
+     395,   399,   403,   407,   415,   419,   423,   427,   435,   439,
+     447,   452,   459,   467,   473,   478,   483,   489,   495,   501,
+     507,   512,   517,   523,   529,   535,   541,   546,   551,   557,
+     563,   568,   574,   579,   584,   590,   596,   606,   610,   614,
+     622,   626,   630,   634
 };
+#endif
 
-/* YYRHS -- A `-1'-separated list of the rules' RHS.  */
-static const yytype_int8 yyrhs[] =
-{
-      24,     0,    -1,    25,     8,    -1,    25,     7,    -1,     8,
-      -1,     7,    -1,     9,     8,    -1,     9,     7,    -1,    26,
-      -1,    25,    18,    25,    -1,    25,    19,    25,    -1,    25,
-      20,    25,    -1,    25,    21,    25,    -1,    25,    22,    25,
-      -1,    27,     9,    28,    29,    -1,    27,     9,    28,     9,
-      29,    -1,    27,    29,    -1,    27,     9,    29,    -1,    30,
-      -1,     9,    30,    -1,    28,     9,    30,    -1,    30,    -1,
-      -1,    29,    10,    30,    -1,    29,    12,    30,    -1,    29,
-      11,    30,    -1,    29,    14,    30,    -1,    29,    15,    30,
-      -1,    29,    13,    30,    -1,    29,    10,    30,     9,    -1,
-      29,    12,    30,     9,    -1,    29,    11,    30,     9,    -1,
-      29,    14,    30,     9,    -1,    29,    15,    30,     9,    -1,
-      29,    13,    30,     9,    -1,    29,    10,     9,    30,    -1,
-      29,    12,     9,    30,    -1,    29,    11,     9,    30,    -1,
-      29,    14,     9,    30,    -1,    29,    15,     9,    30,    -1,
-      29,    13,     9,    30,    -1,    29,    10,     9,    30,     9,
-      -1,    29,    12,     9,    30,     9,    -1,    29,    11,     9,
-      30,     9,    -1,    29,    15,     9,    30,     9,    -1,    29,
-      14,     9,    30,     9,    -1,    29,    13,     9,    30,     9,
-      -1,    30,    16,    -1,    30,    17,    -1,    16,    -1,    17,
-      -1
-};
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
 
-/* YYRLINE[YYN] -- source line where rule number YYN was defined.  */
-static const yytype_uint16 yyrline[] =
-{
-       0,   257,   257,   262,   267,   272,   277,   282,   291,   295,
-     299,   303,   307,   311,   319,   323,   327,   331,   339,   343,
-     351,   356,   363,   370,   376,   381,   386,   392,   398,   403,
-     409,   414,   419,   425,   431,   436,   442,   447,   452,   458,
-     464,   468,   474,   479,   484,   490,   496,   505,   509,   513,
-     517
-};
-#endif
+#if 1
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
 
-#if YYDEBUG || YYERROR_VERBOSE || YYTOKEN_TABLE
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
 {
-  "$end", "error", "$undefined", "NOT_ACCEPTED_CHAR",
+  "\"end of file\"", "error", "\"invalid token\"", "NOT_ACCEPTED_CHAR",
   "INVALID_ENVIRONMENT_VAR", "UNEXPECTED_EOF", "CHARS_AFTER_EOL",
   "END_OF_FILE", "END_OF_LINE", "BLANK", "REDIRECT_OE", "REDIRECT_O",
-  "REDIRECT_E", "INDIRECT", "REDIRECT_APPEND_E", "REDIRECT_APPEND_O",
-  "WORD", "ENV_VAR", "SEQUENTIAL", "PARALLEL", "CONDITIONAL_ZERO",
-  "CONDITIONAL_NZERO", "PIPE", "$accept", "command_tree", "command",
-  "simple_command", "exe_name", "params", "redirect", "word", 0
+  "REDIRECT_E", "INDIRECT", "HERE_DOC", "HERE_STRING", "REDIRECT_APPEND_E",
+  "REDIRECT_APPEND_O", "WORD", "ENV_VAR", "SEQUENTIAL", "PARALLEL",
+  "CONDITIONAL_NZERO", "CONDITIONAL_ZERO", "PIPE", "$accept",
+  "command_tree", "command", "simple_command", "exe_name", "params",
+  "redirect", "indirect", "word", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[YYLEX-NUM] -- Internal token number corresponding to
-   token YYLEX-NUM.  */
-static const yytype_uint16 yytoknum[] =
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
 {
-       0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
-     265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
-     275,   276,   277
-};
-# endif
+  return yytname[yysymbol];
+}
+#endif
 
-/* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
-static const yytype_uint8 yyr1[] =
-{
-       0,    23,    24,    24,    24,    24,    24,    24,    25,    25,
-      25,    25,    25,    25,    26,    26,    26,    26,    27,    27,
-      28,    28,    29,    29,    29,    29,    29,    29,    29,    29,
-      29,    29,    29,    29,    29,    29,    29,    29,    29,    29,
-      29,    29,    29,    29,    29,    29,    29,    30,    30,    30,
-      30
-};
+#define YYPACT_NINF (-21)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-1)
+
+#define yytable_value_is_error(Yyn) \
+  0
 
-/* YYR2[YYN] -- Number of symbols composing right hand side of rule YYN.  */
-static const yytype_uint8 yyr2[] =
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int8 yypact[] =
 {
-       0,     2,     2,     2,     1,     1,     2,     2,     1,     3,
-       3,     3,     3,     3,     4,     5,     2,     3,     1,     2,
-       3,     1,     0,     3,     3,     3,     3,     3,     3,     4,
-       4,     4,     4,     4,     4,     4,     4,     4,     4,     4,
-       4,     5,     5,     5,     5,     5,     5,     2,     2,     1,
-       1
+      -2,   -21,   -21,     2,   -21,   -21,     1,     6,   -21,    -1,
+     -15,   -21,   -21,   -15,   -21,   -21,   -21,    37,    37,    37,
+      37,    37,    92,   110,   -21,   -21,    92,   112,    13,   -13,
+     -13,   -21,     9,   110,   -15,    39,    41,    43,   -21,   -21,
+     -21,    45,    56,    58,    92,   110,    92,    60,    92,    62,
+      92,    64,    92,    75,    92,    77,    92,    79,   110,   -15,
+      81,   -21,    83,   -21,    94,   -21,    96,   -21,    98,   -21,
+     100,   -21,   -21,   -21,   -21,   -21,   -21,   -21
 };
 
-/* YYDEFACT[STATE-NAME] -- Default rule to reduce with in state
-   STATE-NUM when YYTABLE doesn't specify something else to do.  Zero
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
    means the default is an error.  */
-static const yytype_uint8 yydefact[] =
+static const yytype_int8 yydefact[] =
 {
-       0,     5,     4,     0,    49,    50,     0,     0,     8,    22,
+       0,     5,     4,     0,    52,    53,     0,     0,     8,    22,
       18,     7,     6,    19,     1,     3,     2,     0,     0,     0,
-       0,     0,    22,    16,    47,    48,     0,     9,    10,    11,
-      12,    13,    22,    17,    21,     0,     0,     0,     0,     0,
-       0,    22,    14,     0,    23,     0,    25,     0,    24,     0,
-      28,     0,    26,     0,    27,    15,    20,    35,    29,    37,
-      31,    36,    30,    40,    34,    38,    32,    39,    33,    41,
-      43,    42,    46,    45,    44
+       0,     0,    22,    16,    50,    51,     0,     9,    10,    12,
+      11,    13,    22,    17,    21,     0,     0,     0,    47,    48,
+      49,     0,     0,     0,    22,    14,     0,    23,     0,    25,
+       0,    24,     0,    26,     0,    27,     0,    28,    15,    20,
+      35,    29,    37,    31,    36,    30,    38,    32,    39,    33,
+      40,    34,    41,    43,    42,    45,    44,    46
+};
+
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int8 yypgoto[] =
+{
+     -21,   -21,   111,   -21,   -21,   -21,   -20,   -21,    -3
 };
 
 /* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_int8 yydefgoto[] =
 {
-      -1,     6,     7,     8,     9,    32,    23,    10
+       0,     6,     7,     8,     9,    32,    23,    43,    10
 };
 
-/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-   STATE-NUM.  */
-#define YYPACT_NINF -22
-static const yytype_int8 yypact[] =
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int8 yytable[] =
 {
-      44,   -22,   -22,    14,   -22,   -22,    10,    -5,   -22,     3,
-     100,   -22,   -22,   100,   -22,   -22,   -22,     9,     9,     9,
-       9,     9,   113,    -6,   -22,   -22,   113,   106,     7,     2,
-       2,   -22,    30,    -6,   100,    38,    40,    49,    53,    55,
-      58,   113,    -6,   113,    64,   113,    67,   113,    69,   113,
-      73,   113,    78,   113,    82,    -6,   100,    84,   -22,    87,
-     -22,    93,   -22,    96,   -22,    98,   -22,   102,   -22,   -22,
-     -22,   -22,   -22,   -22,   -22
+      13,    14,    33,    24,    25,     1,     2,     3,    22,    11,
+      12,    21,    45,    15,    16,     0,     4,     5,    44,    34,
+       4,     5,     0,    13,    58,     0,    17,    18,    19,    20,
+      21,     0,    47,    49,    51,    19,    20,    21,    53,    55,
+      57,    59,     0,    60,     0,    62,    26,    64,    46,    66,
+      48,    68,    50,    70,    52,     4,     5,     4,     5,     4,
+       5,     4,     5,     4,     5,    54,     0,    56,     0,    61,
+       0,    63,     0,    65,     4,     5,     4,     5,    24,    25,
+      24,    25,    24,    25,    67,     0,    69,     0,    71,     0,
+      72,     0,    73,    24,    25,    24,    25,    24,    25,    24,
+      25,    24,    25,    74,     0,    75,     0,    76,     0,    77,
+       4,     5,    24,    25,    24,    25,    24,    25,    24,    25,
+      35,    36,    37,    38,    39,    40,    41,    42,    27,    28,
+      29,    30,    31,    18,    19,    20,    21
 };
 
-/* YYPGOTO[NTERM-NUM].  */
-static const yytype_int8 yypgoto[] =
+static const yytype_int8 yycheck[] =
 {
-     -22,   -22,   103,   -22,   -22,   -22,   -21,    -3
+       3,     0,    22,    18,    19,     7,     8,     9,     9,     7,
+       8,    24,    32,     7,     8,    -1,    18,    19,     9,    22,
+      18,    19,    -1,    26,    44,    -1,    20,    21,    22,    23,
+      24,    -1,    35,    36,    37,    22,    23,    24,    41,    42,
+      43,    44,    -1,    46,    -1,    48,     9,    50,     9,    52,
+       9,    54,     9,    56,     9,    18,    19,    18,    19,    18,
+      19,    18,    19,    18,    19,     9,    -1,     9,    -1,     9,
+      -1,     9,    -1,     9,    18,    19,    18,    19,    18,    19,
+      18,    19,    18,    19,     9,    -1,     9,    -1,     9,    -1,
+       9,    -1,     9,    18,    19,    18,    19,    18,    19,    18,
+      19,    18,    19,     9,    -1,     9,    -1,     9,    -1,     9,
+      18,    19,    18,    19,    18,    19,    18,    19,    18,    19,
+      10,    11,    12,    13,    14,    15,    16,    17,    17,    18,
+      19,    20,    21,    21,    22,    23,    24
 };
 
-/* YYTABLE[YYPACT[STATE-NUM]].  What to do in state STATE-NUM.  If
-   positive, shift that token.  If negative, reduce the rule which
-   number is the opposite.  If zero, do what YYDEFACT says.
-   If YYTABLE_NINF, syntax error.  */
-#define YYTABLE_NINF -1
-static const yytype_uint8 yytable[] =
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
 {
-      13,    33,    15,    16,    35,    36,    37,    38,    39,    40,
-      14,    42,    22,    17,    18,    19,    20,    21,    26,    34,
-      55,    11,    12,    13,    21,     4,     5,    19,    20,    21,
-       4,     5,    44,    46,    48,    50,    52,    54,    56,    41,
-      57,     0,    59,     0,    61,     0,    63,    43,    65,    45,
-      67,     1,     2,     3,     4,     5,     4,     5,    47,     0,
-       4,     5,    49,     0,    51,     4,     5,    53,     0,     4,
-       5,     4,     5,    58,     4,     5,    60,     0,    62,     0,
-      24,    25,    64,    24,    25,    24,    25,    66,     0,    24,
-      25,    68,     0,    69,    24,    25,    70,     0,    24,    25,
-      24,    25,    71,    24,    25,    72,     0,    73,     0,    24,
-      25,    74,    24,    25,    24,    25,    24,    25,    24,    25,
-      27,    28,    29,    30,    31,    18,    19,    20,    21,     4,
-       5
+       0,     7,     8,     9,    18,    19,    26,    27,    28,    29,
+      33,     7,     8,    33,     0,     7,     8,    20,    21,    22,
+      23,    24,     9,    31,    18,    19,     9,    27,    27,    27,
+      27,    27,    30,    31,    33,    10,    11,    12,    13,    14,
+      15,    16,    17,    32,     9,    31,     9,    33,     9,    33,
+       9,    33,     9,    33,     9,    33,     9,    33,    31,    33,
+      33,     9,    33,     9,    33,     9,    33,     9,    33,     9,
+      33,     9,     9,     9,     9,     9,     9,     9
 };
 
-static const yytype_int8 yycheck[] =
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
 {
-       3,    22,     7,     8,    10,    11,    12,    13,    14,    15,
-       0,    32,     9,    18,    19,    20,    21,    22,     9,    22,
-      41,     7,     8,    26,    22,    16,    17,    20,    21,    22,
-      16,    17,    35,    36,    37,    38,    39,    40,    41,     9,
-      43,    -1,    45,    -1,    47,    -1,    49,     9,    51,     9,
-      53,     7,     8,     9,    16,    17,    16,    17,     9,    -1,
-      16,    17,     9,    -1,     9,    16,    17,     9,    -1,    16,
-      17,    16,    17,     9,    16,    17,     9,    -1,     9,    -1,
-      16,    17,     9,    16,    17,    16,    17,     9,    -1,    16,
-      17,     9,    -1,     9,    16,    17,     9,    -1,    16,    17,
-      16,    17,     9,    16,    17,     9,    -1,     9,    -1,    16,
-      17,     9,    16,    17,    16,    17,    16,    17,    16,    17,
-      17,    18,    19,    20,    21,    19,    20,    21,    22,    16,
-      17
+       0,    25,    26,    26,    26,    26,    26,    26,    27,    27,
+      27,    27,    27,    27,    28,    28,    28,    28,    29,    29,
+      30,    30,    31,    31,    31,    31,    31,    31,    31,    31,
+      31,    31,    31,    31,    31,    31,    31,    31,    31,    31,
+      31,    31,    31,    31,    31,    31,    31,    32,    32,    32,
+      33,    33,    33,    33
 };
 
-/* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-   symbol of state STATE-NUM.  */
-static const yytype_uint8 yystos[] =
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
 {
-       0,     7,     8,     9,    16,    17,    24,    25,    26,    27,
-      30,     7,     8,    30,     0,     7,     8,    18,    19,    20,
-      21,    22,     9,    29,    16,    17,     9,    25,    25,    25,
-      25,    25,    28,    29,    30,    10,    11,    12,    13,    14,
-      15,     9,    29,     9,    30,     9,    30,     9,    30,     9,
-      30,     9,    30,     9,    30,    29,    30,    30,     9,    30,
-       9,    30,     9,    30,     9,    30,     9,    30,     9,     9,
-       9,     9,     9,     9,     9
+       0,     2,     2,     2,     1,     1,     2,     2,     1,     3,
+       3,     3,     3,     3,     4,     5,     2,     3,     1,     2,
+       3,     1,     0,     3,     3,     3,     3,     3,     3,     4,
+       4,     4,     4,     4,     4,     4,     4,     4,     4,     4,
+       4,     5,     5,     5,     5,     5,     5,     1,     1,     1,
+       2,     2,     1,     1
 };
 
-#define yyerrok		(yyerrstatus = 0)
-#define yyclearin	(yychar = YYEMPTY)
-#define YYEMPTY		(-2)
-#define YYEOF		0
 
-#define YYACCEPT	goto yyacceptlab
-#define YYABORT		goto yyabortlab
-#define YYERROR		goto yyerrorlab
+enum { YYENOMEM = -2 };
 
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
 
-/* Like YYERROR except do call yyerror.  This remains here temporarily
-   to ease the transition to the new meaning of YYERROR, for GCC.
-   Once GCC version 2 has supplanted version 1, this can go.  */
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
-#define YYFAIL		goto yyerrlab
 
 #define YYRECOVERING()  (!!yyerrstatus)
 
-#define YYBACKUP(Token, Value)					\
-do								\
-  if (yychar == YYEMPTY && yylen == 1)				\
-    {								\
-      yychar = (Token);						\
-      yylval = (Value);						\
-      yytoken = YYTRANSLATE (yychar);				\
-      YYPOPSTACK (1);						\
-      goto yybackup;						\
-    }								\
-  else								\
-    {								\
-      yyerror (YY_("syntax error: cannot back up")); \
-      YYERROR;							\
-    }								\
-while (YYID (0))
-
-
-#define YYTERROR	1
-#define YYERRCODE	256
-
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (&yylloc, lexer, root, YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
 
 /* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
    If N is 0, then set CURRENT to the empty location which ends
    the previous symbol: RHS[0] (always defined).  */
 
-#define YYRHSLOC(Rhs, K) ((Rhs)[K])
 #ifndef YYLLOC_DEFAULT
-# define YYLLOC_DEFAULT(Current, Rhs, N)				\
-    do									\
-      if (YYID (N))                                                    \
-	{								\
-	  (Current).first_line   = YYRHSLOC (Rhs, 1).first_line;	\
-	  (Current).first_column = YYRHSLOC (Rhs, 1).first_column;	\
-	  (Current).last_line    = YYRHSLOC (Rhs, N).last_line;		\
-	  (Current).last_column  = YYRHSLOC (Rhs, N).last_column;	\
-	}								\
-      else								\
-	{								\
-	  (Current).first_line   = (Current).last_line   =		\
-	    YYRHSLOC (Rhs, 0).last_line;				\
-	  (Current).first_column = (Current).last_column =		\
-	    YYRHSLOC (Rhs, 0).last_column;				\
-	}								\
-    while (YYID (0))
-#endif
-
-
-/* YY_LOCATION_PRINT -- Print the location on the stream.
-   This macro was not mandated originally: define only if we know
-   we won't break user code: when these are the locations we know.  */
-
-#ifndef YY_LOCATION_PRINT
-# if YYLTYPE_IS_TRIVIAL
-#  define YY_LOCATION_PRINT(File, Loc)			\
-     fprintf (File, "%d.%d-%d.%d",			\
-	      (Loc).first_line, (Loc).first_column,	\
-	      (Loc).last_line,  (Loc).last_column)
-# else
-#  define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-# endif
+# define YYLLOC_DEFAULT(Current, Rhs, N)                                \
+    do                                                                  \
+      if (N)                                                            \
+        {                                                               \
+          (Current).first_line   = YYRHSLOC (Rhs, 1).first_line;        \
+          (Current).first_column = YYRHSLOC (Rhs, 1).first_column;      \
+          (Current).last_line    = YYRHSLOC (Rhs, N).last_line;         \
+          (Current).last_column  = YYRHSLOC (Rhs, N).last_column;       \
+        }                                                               \
+      else                                                              \
+        {                                                               \
+          (Current).first_line   = (Current).last_line   =              \
+            YYRHSLOC (Rhs, 0).last_line;                                \
+          (Current).first_column = (Current).last_column =              \
+            YYRHSLOC (Rhs, 0).last_column;                              \
+        }                                                               \
+    while (0)
 #endif
 
+#define YYRHSLOC(Rhs, K) ((Rhs)[K])
 
-/* YYLEX -- calling `yylex' with the right arguments.  */
-
-#ifdef YYLEX_PARAM
-# define YYLEX yylex (YYLEX_PARAM)
-#else
-# define YYLEX yylex ()
-#endif
 
 /* Enable debugging if requested.  */
 #if YYDEBUG
@@ -950,85 +1051,120 @@ while (YYID (0))
 #  define YYFPRINTF fprintf
 # endif
 
-# define YYDPRINTF(Args)			\
-do {						\
-  if (yydebug)					\
-    YYFPRINTF Args;				\
-} while (YYID (0))
-
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)			  \
-do {									  \
-  if (yydebug)								  \
-    {									  \
-      YYFPRINTF (stderr, "%s ", Title);					  \
-      yy_symbol_print (stderr,						  \
-		  Type, Value, Location); \
-      YYFPRINTF (stderr, "\n");						  \
-    }									  \
-} while (YYID (0))
-
-
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
-
-/*ARGSUSED*/
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
-#else
-static void
-yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp)
-    FILE *yyoutput;
-    int yytype;
-    YYSTYPE const * const yyvaluep;
-    YYLTYPE const * const yylocationp;
-#endif
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+/* YYLOCATION_PRINT -- Print the location on the stream.
+   This macro was not mandated originally: define only if we know
+   we won't break user code: when these are the locations we know.  */
+
+# ifndef YYLOCATION_PRINT
+
+#  if defined YY_LOCATION_PRINT
+
+   /* Temporary convenience wrapper in case some people defined the
+      undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YYLOCATION_PRINT(File, Loc)  YY_LOCATION_PRINT(File, *(Loc))
+
+#  elif defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
+
+/* Print *YYLOCP on YYO.  Private, do not rely on its existence. */
+
+YY_ATTRIBUTE_UNUSED
+static int
+yy_location_print_ (FILE *yyo, YYLTYPE const * const yylocp)
 {
-  if (!yyvaluep)
-    return;
-  YYUSE (yylocationp);
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyoutput, yytoknum[yytype], *yyvaluep);
-# else
-  YYUSE (yyoutput);
-# endif
-  switch (yytype)
+  int res = 0;
+  int end_col = 0 != yylocp->last_column ? yylocp->last_column - 1 : 0;
+  if (0 <= yylocp->first_line)
+    {
+      res += YYFPRINTF (yyo, "%d", yylocp->first_line);
+      if (0 <= yylocp->first_column)
+        res += YYFPRINTF (yyo, ".%d", yylocp->first_column);
+    }
+  if (0 <= yylocp->last_line)
     {
-      default:
-	break;
+      if (yylocp->first_line < yylocp->last_line)
+        {
+          res += YYFPRINTF (yyo, "-%d", yylocp->last_line);
+          if (0 <= end_col)
+            res += YYFPRINTF (yyo, ".%d", end_col);
+        }
+      else if (0 <= end_col && yylocp->first_column < end_col)
+        res += YYFPRINTF (yyo, "-%d", end_col);
     }
+  return res;
 }
 
+#   define YYLOCATION_PRINT  yy_location_print_
+
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT(File, Loc)  YYLOCATION_PRINT(File, &(Loc))
+
+#  else
+
+#   define YYLOCATION_PRINT(File, Loc) ((void) 0)
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT  YYLOCATION_PRINT
+
+#  endif
+# endif /* !defined YYLOCATION_PRINT */
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value, Location, lexer, root); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
 
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
 static void
-yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
-#else
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, lexer_t * lexer, command_t ** root)
+{
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  YY_USE (yylocationp);
+  YY_USE (lexer);
+  YY_USE (root);
+  if (!yyvaluep)
+    return;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
+
 static void
-yy_symbol_print (yyoutput, yytype, yyvaluep, yylocationp)
-    FILE *yyoutput;
-    int yytype;
-    YYSTYPE const * const yyvaluep;
-    YYLTYPE const * const yylocationp;
-#endif
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, lexer_t * lexer, command_t ** root)
 {
-  if (yytype < YYNTOKENS)
-    YYFPRINTF (yyoutput, "token %s (", yytname[yytype]);
-  else
-    YYFPRINTF (yyoutput, "nterm %s (", yytname[yytype]);
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  YY_LOCATION_PRINT (yyoutput, *yylocationp);
-  YYFPRINTF (yyoutput, ": ");
-  yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp);
-  YYFPRINTF (yyoutput, ")");
+  YYLOCATION_PRINT (yyo, yylocationp);
+  YYFPRINTF (yyo, ": ");
+  yy_symbol_value_print (yyo, yykind, yyvaluep, yylocationp, lexer, root);
+  YYFPRINTF (yyo, ")");
 }
 
 /*------------------------------------------------------------------.
@@ -1036,81 +1172,69 @@ yy_symbol_print (yyoutput, yytype, yyvaluep, yylocationp)
 | TOP (included).                                                   |
 `------------------------------------------------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_stack_print (yytype_int16 *bottom, yytype_int16 *top)
-#else
 static void
-yy_stack_print (bottom, top)
-    yytype_int16 *bottom;
-    yytype_int16 *top;
-#endif
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
 {
   YYFPRINTF (stderr, "Stack now");
-  for (; bottom <= top; ++bottom)
-    YYFPRINTF (stderr, " %d", *bottom);
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
   YYFPRINTF (stderr, "\n");
 }
 
-# define YY_STACK_PRINT(Bottom, Top)				\
-do {								\
-  if (yydebug)							\
-    yy_stack_print ((Bottom), (Top));				\
-} while (YYID (0))
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
 
 
 /*------------------------------------------------.
 | Report that the YYRULE is going to be reduced.  |
 `------------------------------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_reduce_print (YYSTYPE *yyvsp, YYLTYPE *yylsp, int yyrule)
-#else
 static void
-yy_reduce_print (yyvsp, yylsp, yyrule)
-    YYSTYPE *yyvsp;
-    YYLTYPE *yylsp;
-    int yyrule;
-#endif
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp,
+                 int yyrule, lexer_t * lexer, command_t ** root)
 {
+  int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
   int yyi;
-  unsigned long int yylno = yyrline[yyrule];
-  YYFPRINTF (stderr, "Reducing stack by rule %d (line %lu):\n",
-	     yyrule - 1, yylno);
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
   /* The symbols being reduced.  */
   for (yyi = 0; yyi < yynrhs; yyi++)
     {
-      fprintf (stderr, "   $%d = ", yyi + 1);
-      yy_symbol_print (stderr, yyrhs[yyprhs[yyrule] + yyi],
-		       &(yyvsp[(yyi + 1) - (yynrhs)])
-		       , &(yylsp[(yyi + 1) - (yynrhs)])		       );
-      fprintf (stderr, "\n");
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)],
+                       &(yylsp[(yyi + 1) - (yynrhs)]), lexer, root);
+      YYFPRINTF (stderr, "\n");
     }
 }
 
-# define YY_REDUCE_PRINT(Rule)		\
-do {					\
-  if (yydebug)				\
-    yy_reduce_print (yyvsp, yylsp, Rule); \
-} while (YYID (0))
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, yylsp, Rule, lexer, root); \
+} while (0)
 
 /* Nonzero means print parse trace.  It is left uninitialized so that
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
 
 
 /* YYINITDEPTH -- initial size of the parser's stacks.  */
-#ifndef	YYINITDEPTH
+#ifndef YYINITDEPTH
 # define YYINITDEPTH 200
 #endif
 
@@ -1125,49 +1249,82 @@ int yydebug;
 # define YYMAXDEPTH 10000
 #endif
 
-
 
-#if YYERROR_VERBOSE
+/* Context of a parse error.  */
+typedef struct
+{
+  yy_state_t *yyssp;
+  yysymbol_kind_t yytoken;
+  YYLTYPE *yylloc;
+} yypcontext_t;
+
+/* Put in YYARG at most YYARGN of the expected tokens given the
+   current YYCTX, and return the number of tokens stored in YYARG.  If
+   YYARG is null, return the number of expected tokens (guaranteed to
+   be less than YYNTOKENS).  Return YYENOMEM on memory exhaustion.
+   Return 0 if there are more than YYARGN expected tokens, yet fill
+   YYARG up to YYARGN. */
+static int
+yypcontext_expected_tokens (const yypcontext_t *yyctx,
+                            yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  int yyn = yypact[+*yyctx->yyssp];
+  if (!yypact_value_is_default (yyn))
+    {
+      /* Start YYX at -YYN if negative to avoid negative indexes in
+         YYCHECK.  In other words, skip the first -YYN actions for
+         this state because they are default actions.  */
+      int yyxbegin = yyn < 0 ? -yyn : 0;
+      /* Stay within bounds of both yycheck and yytname.  */
+      int yychecklim = YYLAST - yyn + 1;
+      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
+      int yyx;
+      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
+        if (yycheck[yyx + yyn] == yyx && yyx != YYSYMBOL_YYerror
+            && !yytable_value_is_error (yytable[yyx + yyn]))
+          {
+            if (!yyarg)
+              ++yycount;
+            else if (yycount == yyargn)
+              return 0;
+            else
+              yyarg[yycount++] = YY_CAST (yysymbol_kind_t, yyx);
+          }
+    }
+  if (yyarg && yycount == 0 && 0 < yyargn)
+    yyarg[0] = YYSYMBOL_YYEMPTY;
+  return yycount;
+}
+
+
 
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen strlen
-#  else
+
+#ifndef yystrlen
+# if defined __GLIBC__ && defined _STRING_H
+#  define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
+# else
 /* Return the length of YYSTR.  */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static YYSIZE_T
+static YYPTRDIFF_T
 yystrlen (const char *yystr)
-#else
-static YYSIZE_T
-yystrlen (yystr)
-    const char *yystr;
-#endif
 {
-  YYSIZE_T yylen;
+  YYPTRDIFF_T yylen;
   for (yylen = 0; yystr[yylen]; yylen++)
     continue;
   return yylen;
 }
-#  endif
 # endif
+#endif
 
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
+#ifndef yystpcpy
+# if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
+#  define yystpcpy stpcpy
+# else
 /* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
    YYDEST.  */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
 static char *
 yystpcpy (char *yydest, const char *yysrc)
-#else
-static char *
-yystpcpy (yydest, yysrc)
-    char *yydest;
-    const char *yysrc;
-#endif
 {
   char *yyd = yydest;
   const char *yys = yysrc;
@@ -1177,10 +1334,10 @@ yystpcpy (yydest, yysrc)
 
   return yyd - 1;
 }
-#  endif
 # endif
+#endif
 
-# ifndef yytnamerr
+#ifndef yytnamerr
 /* Copy to YYRES the contents of YYSTR after stripping away unnecessary
    quotes and backslashes, so that it's suitable for yyerror.  The
    heuristic is that double-quoting is unnecessary unless the string
@@ -1188,430 +1345,437 @@ yystpcpy (yydest, yysrc)
    backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
    null, do not copy; instead, return the length of what the result
    would have been.  */
-static YYSIZE_T
+static YYPTRDIFF_T
 yytnamerr (char *yyres, const char *yystr)
 {
   if (*yystr == '"')
     {
-      YYSIZE_T yyn = 0;
+      YYPTRDIFF_T yyn = 0;
       char const *yyp = yystr;
-
       for (;;)
-	switch (*++yyp)
-	  {
-	  case '\'':
-	  case ',':
-	    goto do_not_strip_quotes;
-
-	  case '\\':
-	    if (*++yyp != '\\')
-	      goto do_not_strip_quotes;
-	    /* Fall through.  */
-	  default:
-	    if (yyres)
-	      yyres[yyn] = *yyp;
-	    yyn++;
-	    break;
-
-	  case '"':
-	    if (yyres)
-	      yyres[yyn] = '\0';
-	    return yyn;
-	  }
+        switch (*++yyp)
+          {
+          case '\'':
+          case ',':
+            goto do_not_strip_quotes;
+
+          case '\\':
+            if (*++yyp != '\\')
+              goto do_not_strip_quotes;
+            else
+              goto append;
+
+          append:
+          default:
+            if (yyres)
+              yyres[yyn] = *yyp;
+            yyn++;
+            break;
+
+          case '"':
+            if (yyres)
+              yyres[yyn] = '\0';
+            return yyn;
+          }
     do_not_strip_quotes: ;
     }
 
-  if (! yyres)
+  if (yyres)
+    return yystpcpy (yyres, yystr) - yyres;
+  else
     return yystrlen (yystr);
-
-  return yystpcpy (yyres, yystr) - yyres;
 }
-# endif
+#endif
 
-/* Copy into YYRESULT an error message about the unexpected token
-   YYCHAR while in state YYSTATE.  Return the number of bytes copied,
-   including the terminating null byte.  If YYRESULT is null, do not
-   copy anything; just return the number of bytes that would be
-   copied.  As a special case, return 0 if an ordinary "syntax error"
-   message will do.  Return YYSIZE_MAXIMUM if overflow occurs during
-   size calculation.  */
-static YYSIZE_T
-yysyntax_error (char *yyresult, int yystate, int yychar)
-{
-  int yyn = yypact[yystate];
 
-  if (! (YYPACT_NINF < yyn && yyn <= YYLAST))
-    return 0;
-  else
+static int
+yy_syntax_error_arguments (const yypcontext_t *yyctx,
+                           yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  /* There are many possibilities here to consider:
+     - If this state is a consistent state with a default action, then
+       the only way this function was invoked is if the default action
+       is an error action.  In that case, don't check for expected
+       tokens because there are none.
+     - The only way there can be no lookahead present (in yychar) is if
+       this state is a consistent state with a default action.  Thus,
+       detecting the absence of a lookahead is sufficient to determine
+       that there is no unexpected or expected token to report.  In that
+       case, just report a simple "syntax error".
+     - Don't assume there isn't a lookahead just because this state is a
+       consistent state with a default action.  There might have been a
+       previous inconsistent state, consistent state with a non-default
+       action, or user semantic action that manipulated yychar.
+     - Of course, the expected token list depends on states to have
+       correct lookahead information, and it depends on the parser not
+       to perform extra reductions after fetching a lookahead from the
+       scanner and before detecting a syntax error.  Thus, state merging
+       (from LALR or IELR) and default reductions corrupt the expected
+       token list.  However, the list is correct for canonical LR with
+       one exception: it will still contain any token that will not be
+       accepted due to an error action in a later state.
+  */
+  if (yyctx->yytoken != YYSYMBOL_YYEMPTY)
     {
-      int yytype = YYTRANSLATE (yychar);
-      YYSIZE_T yysize0 = yytnamerr (0, yytname[yytype]);
-      YYSIZE_T yysize = yysize0;
-      YYSIZE_T yysize1;
-      int yysize_overflow = 0;
-      enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-      char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
-      int yyx;
-
-# if 0
-      /* This is so xgettext sees the translatable formats that are
-	 constructed on the fly.  */
-      YY_("syntax error, unexpected %s");
-      YY_("syntax error, unexpected %s, expecting %s");
-      YY_("syntax error, unexpected %s, expecting %s or %s");
-      YY_("syntax error, unexpected %s, expecting %s or %s or %s");
-      YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s");
-# endif
-      char *yyfmt;
-      char const *yyf;
-      static char const yyunexpected[] = "syntax error, unexpected %s";
-      static char const yyexpecting[] = ", expecting %s";
-      static char const yyor[] = " or %s";
-      char yyformat[sizeof yyunexpected
-		    + sizeof yyexpecting - 1
-		    + ((YYERROR_VERBOSE_ARGS_MAXIMUM - 2)
-		       * (sizeof yyor - 1))];
-      char const *yyprefix = yyexpecting;
+      int yyn;
+      if (yyarg)
+        yyarg[yycount] = yyctx->yytoken;
+      ++yycount;
+      yyn = yypcontext_expected_tokens (yyctx,
+                                        yyarg ? yyarg + 1 : yyarg, yyargn - 1);
+      if (yyn == YYENOMEM)
+        return YYENOMEM;
+      else
+        yycount += yyn;
+    }
+  return yycount;
+}
 
-      /* Start YYX at -YYN if negative to avoid negative indexes in
-	 YYCHECK.  */
-      int yyxbegin = yyn < 0 ? -yyn : 0;
+/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
+   about the unexpected token YYTOKEN for the state stack whose top is
+   YYSSP.
 
-      /* Stay within bounds of both yycheck and yytname.  */
-      int yychecklim = YYLAST - yyn + 1;
-      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-      int yycount = 1;
+   Return 0 if *YYMSG was successfully written.  Return -1 if *YYMSG is
+   not large enough to hold the message.  In that case, also set
+   *YYMSG_ALLOC to the required number of bytes.  Return YYENOMEM if the
+   required number of bytes is too large to store.  */
+static int
+yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
+                const yypcontext_t *yyctx)
+{
+  enum { YYARGS_MAX = 5 };
+  /* Internationalized format string. */
+  const char *yyformat = YY_NULLPTR;
+  /* Arguments of yyformat: reported tokens (one for the "unexpected",
+     one per "expected"). */
+  yysymbol_kind_t yyarg[YYARGS_MAX];
+  /* Cumulated lengths of YYARG.  */
+  YYPTRDIFF_T yysize = 0;
+
+  /* Actual size of YYARG. */
+  int yycount = yy_syntax_error_arguments (yyctx, yyarg, YYARGS_MAX);
+  if (yycount == YYENOMEM)
+    return YYENOMEM;
+
+  switch (yycount)
+    {
+#define YYCASE_(N, S)                       \
+      case N:                               \
+        yyformat = S;                       \
+        break
+    default: /* Avoid compiler warnings. */
+      YYCASE_(0, YY_("syntax error"));
+      YYCASE_(1, YY_("syntax error, unexpected %s"));
+      YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
+      YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
+      YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
+      YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
+#undef YYCASE_
+    }
 
-      yyarg[0] = yytname[yytype];
-      yyfmt = yystpcpy (yyformat, yyunexpected);
+  /* Compute error message size.  Don't count the "%s"s, but reserve
+     room for the terminator.  */
+  yysize = yystrlen (yyformat) - 2 * yycount + 1;
+  {
+    int yyi;
+    for (yyi = 0; yyi < yycount; ++yyi)
+      {
+        YYPTRDIFF_T yysize1
+          = yysize + yytnamerr (YY_NULLPTR, yytname[yyarg[yyi]]);
+        if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
+          yysize = yysize1;
+        else
+          return YYENOMEM;
+      }
+  }
 
-      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-	if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR)
-	  {
-	    if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-	      {
-		yycount = 1;
-		yysize = yysize0;
-		yyformat[sizeof yyunexpected - 1] = '\0';
-		break;
-	      }
-	    yyarg[yycount++] = yytname[yyx];
-	    yysize1 = yysize + yytnamerr (0, yytname[yyx]);
-	    yysize_overflow |= (yysize1 < yysize);
-	    yysize = yysize1;
-	    yyfmt = yystpcpy (yyfmt, yyprefix);
-	    yyprefix = yyor;
-	  }
-
-      yyf = YY_(yyformat);
-      yysize1 = yysize + yystrlen (yyf);
-      yysize_overflow |= (yysize1 < yysize);
-      yysize = yysize1;
-
-      if (yysize_overflow)
-	return YYSIZE_MAXIMUM;
-
-      if (yyresult)
-	{
-	  /* Avoid sprintf, as that infringes on the user's name space.
-	     Don't have undefined behavior even if the translation
-	     produced a string with the wrong number of "%s"s.  */
-	  char *yyp = yyresult;
-	  int yyi = 0;
-	  while ((*yyp = *yyf) != '\0')
-	    {
-	      if (*yyp == '%' && yyf[1] == 's' && yyi < yycount)
-		{
-		  yyp += yytnamerr (yyp, yyarg[yyi++]);
-		  yyf += 2;
-		}
-	      else
-		{
-		  yyp++;
-		  yyf++;
-		}
-	    }
-	}
-      return yysize;
+  if (*yymsg_alloc < yysize)
+    {
+      *yymsg_alloc = 2 * yysize;
+      if (! (yysize <= *yymsg_alloc
+             && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
+        *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
+      return -1;
     }
+
+  /* Avoid sprintf, as that infringes on the user's name space.
+     Don't have undefined behavior even if the translation
+     produced a string with the wrong number of "%s"s.  */
+  {
+    char *yyp = *yymsg;
+    int yyi = 0;
+    while ((*yyp = *yyformat) != '\0')
+      if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
+        {
+          yyp += yytnamerr (yyp, yytname[yyarg[yyi++]]);
+          yyformat += 2;
+        }
+      else
+        {
+          ++yyp;
+          ++yyformat;
+        }
+  }
+  return 0;
 }
-#endif /* YYERROR_VERBOSE */
-
+
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
-/*ARGSUSED*/
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocationp)
-#else
-static void
-yydestruct (yymsg, yytype, yyvaluep, yylocationp)
-    const char *yymsg;
-    int yytype;
-    YYSTYPE *yyvaluep;
-    YYLTYPE *yylocationp;
-#endif
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, YYLTYPE *yylocationp, lexer_t * lexer, command_t ** root)
 {
-  YYUSE (yyvaluep);
-  YYUSE (yylocationp);
-
+  YY_USE (yyvaluep);
+  YY_USE (yylocationp);
+  YY_USE (lexer);
+  YY_USE (root);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
-
-  switch (yytype)
-    {
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
-      default:
-	break;
-    }
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
-
 
-/* Prevent warnings from -Wmissing-prototypes.  */
-
-#ifdef YYPARSE_PARAM
-#if defined __STDC__ || defined __cplusplus
-int yyparse (void *YYPARSE_PARAM);
-#else
-int yyparse ();
-#endif
-#else /* ! YYPARSE_PARAM */
-#if defined __STDC__ || defined __cplusplus
-int yyparse (void);
-#else
-int yyparse ();
-#endif
-#endif /* ! YYPARSE_PARAM */
 
 
 
-/* The look-ahead symbol.  */
-int yychar;
-
-/* The semantic value of the look-ahead symbol.  */
-YYSTYPE yylval;
-
-/* Number of syntax errors so far.  */
-int yynerrs;
-/* Location data for the look-ahead symbol.  */
-YYLTYPE yylloc;
-
 
 
 /*----------.
 | yyparse.  |
 `----------*/
 
-#ifdef YYPARSE_PARAM
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
 int
-yyparse (void *YYPARSE_PARAM)
-#else
-int
-yyparse (YYPARSE_PARAM)
-    void *YYPARSE_PARAM;
-#endif
-#else /* ! YYPARSE_PARAM */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-int
-yyparse (void)
-#else
-int
-yyparse ()
-
-#endif
-#endif
+yyparse (lexer_t * lexer, command_t ** root)
 {
-  
-  int yystate;
-  int yyn;
-  int yyresult;
-  /* Number of tokens to shift before error messages enabled.  */
-  int yyerrstatus;
-  /* Look-ahead token as an internal (translated) token number.  */
-  int yytoken = 0;
-#if YYERROR_VERBOSE
-  /* Buffer for error messages, and its allocated size.  */
-  char yymsgbuf[128];
-  char *yymsg = yymsgbuf;
-  YYSIZE_T yymsg_alloc = sizeof yymsgbuf;
-#endif
+/* Lookahead token kind.  */
+int yychar;
 
-  /* Three stacks and their tools:
-     `yyss': related to states,
-     `yyvs': related to semantic values,
-     `yyls': related to locations.
 
-     Refer to the stacks thru separate pointers, to allow yyoverflow
-     to reallocate them elsewhere.  */
+/* The semantic value of the lookahead symbol.  */
+/* Default value used for initialization, for pacifying older GCCs
+   or non-GCC compilers.  */
+YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
+YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
 
-  /* The state stack.  */
-  yytype_int16 yyssa[YYINITDEPTH];
-  yytype_int16 *yyss = yyssa;
-  yytype_int16 *yyssp;
+/* Location data for the lookahead symbol.  */
+static YYLTYPE yyloc_default
+# if defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
+  = { 1, 1, 1, 1 }
+# endif
+;
+YYLTYPE yylloc = yyloc_default;
 
-  /* The semantic value stack.  */
-  YYSTYPE yyvsa[YYINITDEPTH];
-  YYSTYPE *yyvs = yyvsa;
-  YYSTYPE *yyvsp;
+    /* Number of syntax errors so far.  */
+    int yynerrs = 0;
 
-  /* The location stack.  */
-  YYLTYPE yylsa[YYINITDEPTH];
-  YYLTYPE *yyls = yylsa;
-  YYLTYPE *yylsp;
-  /* The locations where the error started and ended.  */
-  YYLTYPE yyerror_range[2];
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
 
-#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N), yylsp -= (N))
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
+
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
 
-  YYSIZE_T yystacksize = YYINITDEPTH;
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
 
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
+
+    /* The location stack: array, bottom, top.  */
+    YYLTYPE yylsa[YYINITDEPTH];
+    YYLTYPE *yyls = yylsa;
+    YYLTYPE *yylsp = yyls;
+
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
   YYLTYPE yyloc;
 
+  /* The locations where the error started and ended.  */
+  YYLTYPE yyerror_range[3];
+
+  /* Buffer for error messages, and its allocated size.  */
+  char yymsgbuf[128];
+  char *yymsg = yymsgbuf;
+  YYPTRDIFF_T yymsg_alloc = sizeof yymsgbuf;
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N), yylsp -= (N))
+
   /* The number of symbols on the RHS of the reduced rule.
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
   YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
-  yychar = YYEMPTY;		/* Cause a token to be read.  */
-
-  /* Initialize stack pointers.
-     Waste one element of value and location stack
-     so that they stay on the same level as the state stack.
-     The wasted elements are never initialized.  */
-
-  yyssp = yyss;
-  yyvsp = yyvs;
-  yylsp = yyls;
-#if YYLTYPE_IS_TRIVIAL
-  /* Initialize the default location before parsing starts.  */
-  yylloc.first_line   = yylloc.last_line   = 1;
-  yylloc.first_column = yylloc.last_column = 0;
-#endif
+  yychar = YYEMPTY; /* Cause a token to be read.  */
 
+
+/* User initialization code.  */
+#line 310 "parser.y"
+{
+	yylloc.first_line = yylloc.last_line = 1;
+	yylloc.first_column = yylloc.last_column = 0;
+}
+
+#line 1641 "parser.tab.c"
+
+  yylsp[0] = yylloc;
   goto yysetstate;
 
+
 /*------------------------------------------------------------.
-| yynewstate -- Push a new state, which is found in yystate.  |
+| yynewstate -- push a new state, which is found in yystate.  |
 `------------------------------------------------------------*/
- yynewstate:
+yynewstate:
   /* In all cases, when you get here, the value and location stacks
      have just been pushed.  So pushing a state here evens the stacks.  */
   yyssp++;
 
- yysetstate:
-  *yyssp = yystate;
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
     {
       /* Get the current used size of the three stacks, in elements.  */
-      YYSIZE_T yysize = yyssp - yyss + 1;
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
 
-#ifdef yyoverflow
+# if defined yyoverflow
       {
-	/* Give user a chance to reallocate the stack.  Use copies of
-	   these so that the &'s don't force the real ones into
-	   memory.  */
-	YYSTYPE *yyvs1 = yyvs;
-	yytype_int16 *yyss1 = yyss;
-	YYLTYPE *yyls1 = yyls;
-
-	/* Each stack pointer address is followed by the size of the
-	   data in use in that stack, in bytes.  This used to be a
-	   conditional around just the two extra args, but that might
-	   be undefined if yyoverflow is a macro.  */
-	yyoverflow (YY_("memory exhausted"),
-		    &yyss1, yysize * sizeof (*yyssp),
-		    &yyvs1, yysize * sizeof (*yyvsp),
-		    &yyls1, yysize * sizeof (*yylsp),
-		    &yystacksize);
-	yyls = yyls1;
-	yyss = yyss1;
-	yyvs = yyvs1;
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+        YYLTYPE *yyls1 = yyls;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yyls1, yysize * YYSIZEOF (*yylsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+        yyls = yyls1;
       }
-#else /* no yyoverflow */
-# ifndef YYSTACK_RELOCATE
-      goto yyexhaustedlab;
-# else
+# else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-	goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
-	yystacksize = YYMAXDEPTH;
+        yystacksize = YYMAXDEPTH;
 
       {
-	yytype_int16 *yyss1 = yyss;
-	union yyalloc *yyptr =
-	  (union yyalloc *) YYSTACK_ALLOC (YYSTACK_BYTES (yystacksize));
-	if (! yyptr)
-	  goto yyexhaustedlab;
-	YYSTACK_RELOCATE (yyss);
-	YYSTACK_RELOCATE (yyvs);
-	YYSTACK_RELOCATE (yyls);
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+        YYSTACK_RELOCATE (yyls_alloc, yyls);
 #  undef YYSTACK_RELOCATE
-	if (yyss1 != yyssa)
-	  YYSTACK_FREE (yyss1);
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
       }
 # endif
-#endif /* no yyoverflow */
 
       yyssp = yyss + yysize - 1;
       yyvsp = yyvs + yysize - 1;
       yylsp = yyls + yysize - 1;
 
-      YYDPRINTF ((stderr, "Stack size increased to %lu\n",
-		  (unsigned long int) yystacksize));
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
 
       if (yyss + yystacksize - 1 <= yyssp)
-	YYABORT;
+        YYABORT;
     }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
-  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
 
   goto yybackup;
 
+
 /*-----------.
 | yybackup.  |
 `-----------*/
 yybackup:
-
   /* Do appropriate processing given the current state.  Read a
-     look-ahead token if we need one and don't already have one.  */
+     lookahead token if we need one and don't already have one.  */
 
-  /* First try to decide what to do without reference to look-ahead token.  */
+  /* First try to decide what to do without reference to lookahead token.  */
   yyn = yypact[yystate];
-  if (yyn == YYPACT_NINF)
+  if (yypact_value_is_default (yyn))
     goto yydefault;
 
-  /* Not known => get a look-ahead token if don't already have one.  */
+  /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid look-ahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-      YYDPRINTF ((stderr, "Reading a token: "));
-      yychar = YYLEX;
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex (&yylval, &yylloc, lexer);
     }
 
   if (yychar <= YYEOF)
     {
-      yychar = yytoken = YYEOF;
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
       YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      yyerror_range[1] = yylloc;
+      goto yyerrlab1;
+    }
   else
     {
       yytoken = YYTRANSLATE (yychar);
@@ -1626,30 +1790,27 @@ yybackup:
   yyn = yytable[yyn];
   if (yyn <= 0)
     {
-      if (yyn == 0 || yyn == YYTABLE_NINF)
-	goto yyerrlab;
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
       yyn = -yyn;
       goto yyreduce;
     }
 
-  if (yyn == YYFINAL)
-    YYACCEPT;
-
   /* Count tokens shifted since error; after three, turn off error
      status.  */
   if (yyerrstatus)
     yyerrstatus--;
 
-  /* Shift the look-ahead token.  */
+  /* Shift the lookahead token.  */
   YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
-
-  /* Discard the shifted token unless it is eof.  */
-  if (yychar != YYEOF)
-    yychar = YYEMPTY;
-
   yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
   *++yylsp = yylloc;
+
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
   goto yynewstate;
 
 
@@ -1664,14 +1825,14 @@ yydefault:
 
 
 /*-----------------------------.
-| yyreduce -- Do a reduction.  |
+| yyreduce -- do a reduction.  |
 `-----------------------------*/
 yyreduce:
   /* yyn is the number of a rule to reduce with.  */
   yylen = yyr2[yyn];
 
   /* If YYLEN is nonzero, implement the default value of the action:
-     `$$ = $1'.
+     '$$ = $1'.
 
      Otherwise, the following line sets YYVAL to garbage.
      This behavior is undocumented and Bison
@@ -1680,496 +1841,582 @@ yyreduce:
      GCC warning that YYVAL may be used uninitialized.  */
   yyval = yyvsp[1-yylen];
 
-  /* Default location.  */
+  /* Default location. */
   YYLLOC_DEFAULT (yyloc, (yylsp - yylen), yylen);
+  yyerror_range[1] = yyloc;
   YY_REDUCE_PRINT (yyn);
   switch (yyn)
     {
-        case 2:
-#line 257 "parser.y"
-    {
-		command_root = (yyvsp[(1) - (2)].command_un);
+  case 2: /* command_tree: command END_OF_LINE  */
+#line 353 "parser.y"
+                              {
+		*root = (yyvsp[-1].command_un);
 		YYACCEPT;
-	;}
+	}
+#line 1857 "parser.tab.c"
     break;
 
-  case 3:
-#line 262 "parser.y"
-    {
-		command_root = (yyvsp[(1) - (2)].command_un);
+  case 3: /* command_tree: command END_OF_FILE  */
+#line 358 "parser.y"
+                              {
+		*root = (yyvsp[-1].command_un);
 		YYACCEPT;
-	;}
+	}
+#line 1866 "parser.tab.c"
     break;
 
-  case 4:
-#line 267 "parser.y"
-    {
-		command_root = NULL;
+  case 4: /* command_tree: END_OF_LINE  */
+#line 363 "parser.y"
+                      {
+		*root = NULL;
 		YYACCEPT;
-	;}
+	}
+#line 1875 "parser.tab.c"
     break;
 
-  case 5:
-#line 272 "parser.y"
-    {
-		command_root = NULL;
+  case 5: /* command_tree: END_OF_FILE  */
+#line 368 "parser.y"
+                      {
+		*root = NULL;
 		YYACCEPT;
-	;}
+	}
+#line 1884 "parser.tab.c"
     break;
 
-  case 6:
-#line 277 "parser.y"
-    {
-		command_root = NULL;
+  case 6: /* command_tree: BLANK END_OF_LINE  */
+#line 373 "parser.y"
+                            {
+		*root = NULL;
 		YYACCEPT;
-	;}
+	}
+#line 1893 "parser.tab.c"
     break;
 
-  case 7:
-#line 282 "parser.y"
-    {
-		command_root = NULL;
+  case 7: /* command_tree: BLANK END_OF_FILE  */
+#line 378 "parser.y"
+                            {
+		*root = NULL;
 		YYACCEPT;
-	;}
+	}
+#line 1902 "parser.tab.c"
     break;
 
-  case 8:
-#line 291 "parser.y"
-    {
-		(yyval.command_un) = new_command((yyvsp[(1) - (1)].simple_command_un));
-	;}
+  case 8: /* command: simple_command  */
+#line 387 "parser.y"
+                         {
+		(yyval.command_un) = new_command((yyvsp[0].simple_command_un));
+	}
+#line 1910 "parser.tab.c"
     break;
 
-  case 9:
-#line 295 "parser.y"
-    {
-		(yyval.command_un) = bind_commands((yyvsp[(1) - (3)].command_un), (yyvsp[(3) - (3)].command_un), OP_SEQUENTIAL);
-	;}
+  case 9: /* command: command SEQUENTIAL command  */
+#line 391 "parser.y"
+                                     {
+		(yyval.command_un) = bind_commands((yyvsp[-2].command_un), (yyvsp[0].command_un), OP_SEQUENTIAL);
+	}
+#line 1918 "parser.tab.c"
     break;
 
-  case 10:
-#line 299 "parser.y"
-    {
-		(yyval.command_un) = bind_commands((yyvsp[(1) - (3)].command_un), (yyvsp[(3) - (3)].command_un), OP_PARALLEL);
-	;}
+  case 10: /* command: command PARALLEL command  */
+#line 395 "parser.y"
+                                   {
+		(yyval.command_un) = bind_commands((yyvsp[-2].command_un), (yyvsp[0].command_un), OP_PARALLEL);
+	}
+#line 1926 "parser.tab.c"
     break;
 
-  case 11:
-#line 303 "parser.y"
-    {
-		(yyval.command_un) = bind_commands((yyvsp[(1) - (3)].command_un), (yyvsp[(3) - (3)].command_un), OP_CONDITIONAL_ZERO);
-	;}
+  case 11: /* command: command CONDITIONAL_ZERO command  */
+#line 399 "parser.y"
+                                           {
+		(yyval.command_un) = bind_commands((yyvsp[-2].command_un), (yyvsp[0].command_un), OP_CONDITIONAL_ZERO);
+	}
+#line 1934 "parser.tab.c"
     break;
 
-  case 12:
-#line 307 "parser.y"
-    {
-		(yyval.command_un) = bind_commands((yyvsp[(1) - (3)].command_un), (yyvsp[(3) - (3)].command_un), OP_CONDITIONAL_NZERO);
-	;}
+  case 12: /* command: command CONDITIONAL_NZERO command  */
+#line 403 "parser.y"
+                                            {
+		(yyval.command_un) = bind_commands((yyvsp[-2].command_un), (yyvsp[0].command_un), OP_CONDITIONAL_NZERO);
+	}
+#line 1942 "parser.tab.c"
     break;
 
-  case 13:
-#line 311 "parser.y"
-    {
-		(yyval.command_un) = bind_commands((yyvsp[(1) - (3)].command_un), (yyvsp[(3) - (3)].command_un), OP_PIPE);
-	;}
+  case 13: /* command: command PIPE command  */
+#line 407 "parser.y"
+                               {
+		(yyval.command_un) = bind_commands((yyvsp[-2].command_un), (yyvsp[0].command_un), OP_PIPE);
+	}
+#line 1950 "parser.tab.c"
     break;
 
-  case 14:
-#line 319 "parser.y"
-    {
-		(yyval.simple_command_un) = bind_parts((yyvsp[(1) - (4)].exe_un), (yyvsp[(3) - (4)].params_un), (yyvsp[(4) - (4)].redirect_un));
-	;}
+  case 14: /* simple_command: exe_name BLANK params redirect  */
+#line 415 "parser.y"
+                                         {
+		(yyval.simple_command_un) = bind_parts((yyvsp[-3].exe_un), (yyvsp[-1].params_un).first, (yyvsp[0].redirect_un));
+	}
+#line 1958 "parser.tab.c"
     break;
 
-  case 15:
-#line 323 "parser.y"
-    {
-		(yyval.simple_command_un) = bind_parts((yyvsp[(1) - (5)].exe_un), (yyvsp[(3) - (5)].params_un), (yyvsp[(5) - (5)].redirect_un));
-	;}
+  case 15: /* simple_command: exe_name BLANK params BLANK redirect  */
+#line 419 "parser.y"
+                                               {
+		(yyval.simple_command_un) = bind_parts((yyvsp[-4].exe_un), (yyvsp[-2].params_un).first, (yyvsp[0].redirect_un));
+	}
+#line 1966 "parser.tab.c"
     break;
 
-  case 16:
-#line 327 "parser.y"
-    {
-		(yyval.simple_command_un) = bind_parts((yyvsp[(1) - (2)].exe_un), NULL, (yyvsp[(2) - (2)].redirect_un));
-	;}
+  case 16: /* simple_command: exe_name redirect  */
+#line 423 "parser.y"
+                            {
+		(yyval.simple_command_un) = bind_parts((yyvsp[-1].exe_un), NULL, (yyvsp[0].redirect_un));
+	}
+#line 1974 "parser.tab.c"
     break;
 
-  case 17:
-#line 331 "parser.y"
-    {
-		(yyval.simple_command_un) = bind_parts((yyvsp[(1) - (3)].exe_un), NULL, (yyvsp[(3) - (3)].redirect_un));
-	;}
+  case 17: /* simple_command: exe_name BLANK redirect  */
+#line 427 "parser.y"
+                                  {
+		(yyval.simple_command_un) = bind_parts((yyvsp[-2].exe_un), NULL, (yyvsp[0].redirect_un));
+	}
+#line 1982 "parser.tab.c"
     break;
 
-  case 18:
-#line 339 "parser.y"
-    {
-		(yyval.exe_un) = (yyvsp[(1) - (1)].word_un);
-	;}
+  case 18: /* exe_name: word  */
+#line 435 "parser.y"
+               {
+		(yyval.exe_un) = (yyvsp[0].word_un).first;
+	}
+#line 1990 "parser.tab.c"
     break;
 
-  case 19:
-#line 343 "parser.y"
-    {
-		(yyval.exe_un) = (yyvsp[(2) - (2)].word_un);
-	;}
+  case 19: /* exe_name: BLANK word  */
+#line 439 "parser.y"
+                     {
+		(yyval.exe_un) = (yyvsp[0].word_un).first;
+	}
+#line 1998 "parser.tab.c"
     break;
 
-  case 20:
-#line 351 "parser.y"
-    {
-		(yyval.params_un) = add_word_to_list((yyvsp[(3) - (3)].word_un), (yyvsp[(1) - (3)].params_un));
-		assert((yyval.params_un) == (yyvsp[(1) - (3)].params_un));
-	;}
+  case 20: /* params: params BLANK word  */
+#line 447 "parser.y"
+                            {
+		(yyval.params_un) = add_word_to_list((yyvsp[0].word_un).first, (yyvsp[-2].params_un));
+		assert((yyval.params_un).first == (yyvsp[-2].params_un).first);
+	}
+#line 2007 "parser.tab.c"
     break;
 
-  case 21:
-#line 356 "parser.y"
-    {
-		(yyval.params_un) = (yyvsp[(1) - (1)].word_un);
-	;}
+  case 21: /* params: word  */
+#line 452 "parser.y"
+               {
+		(yyval.params_un) = new_list((yyvsp[0].word_un).first);
+	}
+#line 2015 "parser.tab.c"
     break;
 
-  case 22:
-#line 363 "parser.y"
-    { /* empty */
-		(yyval.redirect_un).red_o = NULL;
-		(yyval.redirect_un).red_i = NULL;
-		(yyval.redirect_un).red_e = NULL;
+  case 22: /* redirect: %empty  */
+#line 459 "parser.y"
+          { /* empty */
+		(yyval.redirect_un).red_o = new_list(NULL);
+		(yyval.redirect_un).red_i = new_list(NULL);
+		(yyval.redirect_un).red_e = new_list(NULL);
+		(yyval.redirect_un).red_here = NULL;
 		(yyval.redirect_un).red_flags = IO_REGULAR;
-	;}
+	}
+#line 2027 "parser.tab.c"
     break;
 
-  case 23:
-#line 370 "parser.y"
-    {
-		(yyvsp[(1) - (3)].redirect_un).red_o = add_word_to_list((yyvsp[(3) - (3)].word_un), (yyvsp[(1) - (3)].redirect_un).red_o);
-		(yyvsp[(1) - (3)].redirect_un).red_e = add_word_to_list((yyvsp[(3) - (3)].word_un), (yyvsp[(1) - (3)].redirect_un).red_e);
-		(yyval.redirect_un) = (yyvsp[(1) - (3)].redirect_un);
-	;}
+  case 23: /* redirect: redirect REDIRECT_OE word  */
+#line 467 "parser.y"
+                                    {
+		(yyvsp[-2].redirect_un).red_o = add_word_to_list((yyvsp[0].word_un).first, (yyvsp[-2].redirect_un).red_o);
+		(yyvsp[-2].redirect_un).red_e = add_word_to_list((yyvsp[0].word_un).first, (yyvsp[-2].redirect_un).red_e);
+		(yyval.redirect_un) = (yyvsp[-2].redirect_un);
+	}
+#line 2037 "parser.tab.c"
     break;
 
-  case 24:
-#line 376 "parser.y"
-    {
-		(yyvsp[(1) - (3)].redirect_un).red_e = add_word_to_list((yyvsp[(3) - (3)].word_un), (yyvsp[(1) - (3)].redirect_un).red_e);
-		(yyval.redirect_un) = (yyvsp[(1) - (3)].redirect_un);
-	;}
+  case 24: /* redirect: redirect REDIRECT_E word  */
+#line 473 "parser.y"
+                                   {
+		(yyvsp[-2].redirect_un).red_e = add_word_to_list((yyvsp[0].word_un).first, (yyvsp[-2].redirect_un).red_e);
+		(yyval.redirect_un) = (yyvsp[-2].redirect_un);
+	}
+#line 2046 "parser.tab.c"
     break;
 
-  case 25:
-#line 381 "parser.y"
-    {
-		(yyvsp[(1) - (3)].redirect_un).red_o = add_word_to_list((yyvsp[(3) - (3)].word_un), (yyvsp[(1) - (3)].redirect_un).red_o);
-		(yyval.redirect_un) = (yyvsp[(1) - (3)].redirect_un);
-	;}
+  case 25: /* redirect: redirect REDIRECT_O word  */
+#line 478 "parser.y"
+                                   {
+		(yyvsp[-2].redirect_un).red_o = add_word_to_list((yyvsp[0].word_un).first, (yyvsp[-2].redirect_un).red_o);
+		(yyval.redirect_un) = (yyvsp[-2].redirect_un);
+	}
+#line 2055 "parser.tab.c"
     break;
 
-  case 26:
-#line 386 "parser.y"
-    {
-		(yyvsp[(1) - (3)].redirect_un).red_e = add_word_to_list((yyvsp[(3) - (3)].word_un), (yyvsp[(1) - (3)].redirect_un).red_e);
-		(yyvsp[(1) - (3)].redirect_un).red_flags |= IO_ERR_APPEND;
-		(yyval.redirect_un) = (yyvsp[(1) - (3)].redirect_un);
-	;}
+  case 26: /* redirect: redirect REDIRECT_APPEND_E word  */
+#line 483 "parser.y"
+                                          {
+		(yyvsp[-2].redirect_un).red_e = add_word_to_list((yyvsp[0].word_un).first, (yyvsp[-2].redirect_un).red_e);
+		(yyvsp[-2].redirect_un).red_flags |= IO_ERR_APPEND;
+		(yyval.redirect_un) = (yyvsp[-2].redirect_un);
+	}
+#line 2065 "parser.tab.c"
     break;
 
-  case 27:
-#line 392 "parser.y"
-    {
-		(yyvsp[(1) - (3)].redirect_un).red_o = add_word_to_list((yyvsp[(3) - (3)].word_un), (yyvsp[(1) - (3)].redirect_un).red_o);
-		(yyvsp[(1) - (3)].redirect_un).red_flags |= IO_OUT_APPEND;
-		(yyval.redirect_un) = (yyvsp[(1) - (3)].redirect_un);
-	;}
+  case 27: /* redirect: redirect REDIRECT_APPEND_O word  */
+#line 489 "parser.y"
+                                          {
+		(yyvsp[-2].redirect_un).red_o = add_word_to_list((yyvsp[0].word_un).first, (yyvsp[-2].redirect_un).red_o);
+		(yyvsp[-2].redirect_un).red_flags |= IO_OUT_APPEND;
+		(yyval.redirect_un) = (yyvsp[-2].redirect_un);
+	}
+#line 2075 "parser.tab.c"
     break;
 
-  case 28:
-#line 398 "parser.y"
-    {
-		(yyvsp[(1) - (3)].redirect_un).red_i = add_word_to_list((yyvsp[(3) - (3)].word_un), (yyvsp[(1) - (3)].redirect_un).red_i);
-		(yyval.redirect_un) = (yyvsp[(1) - (3)].redirect_un);
-	;}
+  case 28: /* redirect: redirect indirect word  */
+#line 495 "parser.y"
+                                 {
+		if (!add_input((yyvsp[0].word_un).first, (yyvsp[-1].flags_un), &(yyvsp[-2].redirect_un), (yylsp[-1]).first_column))
+			YYERROR;
+		(yyval.redirect_un) = (yyvsp[-2].redirect_un);
+	}
+#line 2085 "parser.tab.c"
     break;
 
-  case 29:
-#line 403 "parser.y"
-    {
-		(yyvsp[(1) - (4)].redirect_un).red_o = add_word_to_list((yyvsp[(3) - (4)].word_un), (yyvsp[(1) - (4)].redirect_un).red_o);
-		(yyvsp[(1) - (4)].redirect_un).red_e = add_word_to_list((yyvsp[(3) - (4)].word_un), (yyvsp[(1) - (4)].redirect_un).red_e);
-		(yyval.redirect_un) = (yyvsp[(1) - (4)].redirect_un);
-	;}
+  case 29: /* redirect: redirect REDIRECT_OE word BLANK  */
+#line 501 "parser.y"
+                                          {
+		(yyvsp[-3].redirect_un).red_o = add_word_to_list((yyvsp[-1].word_un).first, (yyvsp[-3].redirect_un).red_o);
+		(yyvsp[-3].redirect_un).red_e = add_word_to_list((yyvsp[-1].word_un).first, (yyvsp[-3].redirect_un).red_e);
+		(yyval.redirect_un) = (yyvsp[-3].redirect_un);
+	}
+#line 2095 "parser.tab.c"
     break;
 
-  case 30:
-#line 409 "parser.y"
-    {
-		(yyvsp[(1) - (4)].redirect_un).red_e = add_word_to_list((yyvsp[(3) - (4)].word_un), (yyvsp[(1) - (4)].redirect_un).red_e);
-		(yyval.redirect_un) = (yyvsp[(1) - (4)].redirect_un);
-	;}
+  case 30: /* redirect: redirect REDIRECT_E word BLANK  */
+#line 507 "parser.y"
+                                         {
+		(yyvsp[-3].redirect_un).red_e = add_word_to_list((yyvsp[-1].word_un).first, (yyvsp[-3].redirect_un).red_e);
+		(yyval.redirect_un) = (yyvsp[-3].redirect_un);
+	}
+#line 2104 "parser.tab.c"
     break;
 
-  case 31:
-#line 414 "parser.y"
-    {
-		(yyvsp[(1) - (4)].redirect_un).red_o = add_word_to_list((yyvsp[(3) - (4)].word_un), (yyvsp[(1) - (4)].redirect_un).red_o);
-		(yyval.redirect_un) = (yyvsp[(1) - (4)].redirect_un);
-	;}
+  case 31: /* redirect: redirect REDIRECT_O word BLANK  */
+#line 512 "parser.y"
+                                         {
+		(yyvsp[-3].redirect_un).red_o = add_word_to_list((yyvsp[-1].word_un).first, (yyvsp[-3].redirect_un).red_o);
+		(yyval.redirect_un) = (yyvsp[-3].redirect_un);
+	}
+#line 2113 "parser.tab.c"
     break;
 
-  case 32:
-#line 419 "parser.y"
-    {
-		(yyvsp[(1) - (4)].redirect_un).red_e = add_word_to_list((yyvsp[(3) - (4)].word_un), (yyvsp[(1) - (4)].redirect_un).red_e);
-		(yyvsp[(1) - (4)].redirect_un).red_flags |= IO_ERR_APPEND;
-		(yyval.redirect_un) = (yyvsp[(1) - (4)].redirect_un);
-	;}
+  case 32: /* redirect: redirect REDIRECT_APPEND_E word BLANK  */
+#line 517 "parser.y"
+                                                {
+		(yyvsp[-3].redirect_un).red_e = add_word_to_list((yyvsp[-1].word_un).first, (yyvsp[-3].redirect_un).red_e);
+		(yyvsp[-3].redirect_un).red_flags |= IO_ERR_APPEND;
+		(yyval.redirect_un) = (yyvsp[-3].redirect_un);
+	}
+#line 2123 "parser.tab.c"
     break;
 
-  case 33:
-#line 425 "parser.y"
-    {
-		(yyvsp[(1) - (4)].redirect_un).red_o = add_word_to_list((yyvsp[(3) - (4)].word_un), (yyvsp[(1) - (4)].redirect_un).red_o);
-		(yyvsp[(1) - (4)].redirect_un).red_flags |= IO_OUT_APPEND;
-		(yyval.redirect_un) = (yyvsp[(1) - (4)].redirect_un);
-	;}
+  case 33: /* redirect: redirect REDIRECT_APPEND_O word BLANK  */
+#line 523 "parser.y"
+                                                {
+		(yyvsp[-3].redirect_un).red_o = add_word_to_list((yyvsp[-1].word_un).first, (yyvsp[-3].redirect_un).red_o);
+		(yyvsp[-3].redirect_un).red_flags |= IO_OUT_APPEND;
+		(yyval.redirect_un) = (yyvsp[-3].redirect_un);
+	}
+#line 2133 "parser.tab.c"
     break;
 
-  case 34:
-#line 431 "parser.y"
-    {
-		(yyvsp[(1) - (4)].redirect_un).red_i = add_word_to_list((yyvsp[(3) - (4)].word_un), (yyvsp[(1) - (4)].redirect_un).red_i);
-		(yyval.redirect_un) = (yyvsp[(1) - (4)].redirect_un);
-	;}
+  case 34: /* redirect: redirect indirect word BLANK  */
+#line 529 "parser.y"
+                                       {
+		if (!add_input((yyvsp[-1].word_un).first, (yyvsp[-2].flags_un), &(yyvsp[-3].redirect_un), (yylsp[-2]).first_column))
+			YYERROR;
+		(yyval.redirect_un) = (yyvsp[-3].redirect_un);
+	}
+#line 2143 "parser.tab.c"
     break;
 
-  case 35:
-#line 436 "parser.y"
-    {
-		(yyvsp[(1) - (4)].redirect_un).red_o = add_word_to_list((yyvsp[(4) - (4)].word_un), (yyvsp[(1) - (4)].redirect_un).red_o);
-		(yyvsp[(1) - (4)].redirect_un).red_e = add_word_to_list((yyvsp[(4) - (4)].word_un), (yyvsp[(1) - (4)].redirect_un).red_e);
-		(yyval.redirect_un) = (yyvsp[(1) - (4)].redirect_un);
-	;}
+  case 35: /* redirect: redirect REDIRECT_OE BLANK word  */
+#line 535 "parser.y"
+                                          {
+		(yyvsp[-3].redirect_un).red_o = add_word_to_list((yyvsp[0].word_un).first, (yyvsp[-3].redirect_un).red_o);
+		(yyvsp[-3].redirect_un).red_e = add_word_to_list((yyvsp[0].word_un).first, (yyvsp[-3].redirect_un).red_e);
+		(yyval.redirect_un) = (yyvsp[-3].redirect_un);
+	}
+#line 2153 "parser.tab.c"
     break;
 
-  case 36:
-#line 442 "parser.y"
-    {
-		(yyvsp[(1) - (4)].redirect_un).red_e = add_word_to_list((yyvsp[(4) - (4)].word_un), (yyvsp[(1) - (4)].redirect_un).red_e);
-		(yyval.redirect_un) = (yyvsp[(1) - (4)].redirect_un);
-	;}
+  case 36: /* redirect: redirect REDIRECT_E BLANK word  */
+#line 541 "parser.y"
+                                         {
+		(yyvsp[-3].redirect_un).red_e = add_word_to_list((yyvsp[0].word_un).first, (yyvsp[-3].redirect_un).red_e);
+		(yyval.redirect_un) = (yyvsp[-3].redirect_un);
+	}
+#line 2162 "parser.tab.c"
     break;
 
-  case 37:
-#line 447 "parser.y"
-    {
-		(yyvsp[(1) - (4)].redirect_un).red_o = add_word_to_list((yyvsp[(4) - (4)].word_un), (yyvsp[(1) - (4)].redirect_un).red_o);
-		(yyval.redirect_un) = (yyvsp[(1) - (4)].redirect_un);
-	;}
+  case 37: /* redirect: redirect REDIRECT_O BLANK word  */
+#line 546 "parser.y"
+                                         {
+		(yyvsp[-3].redirect_un).red_o = add_word_to_list((yyvsp[0].word_un).first, (yyvsp[-3].redirect_un).red_o);
+		(yyval.redirect_un) = (yyvsp[-3].redirect_un);
+	}
+#line 2171 "parser.tab.c"
     break;
 
-  case 38:
-#line 452 "parser.y"
-    {
-		(yyvsp[(1) - (4)].redirect_un).red_e = add_word_to_list((yyvsp[(4) - (4)].word_un), (yyvsp[(1) - (4)].redirect_un).red_e);
-		(yyvsp[(1) - (4)].redirect_un).red_flags |= IO_ERR_APPEND;
-		(yyval.redirect_un) = (yyvsp[(1) - (4)].redirect_un);
-	;}
+  case 38: /* redirect: redirect REDIRECT_APPEND_E BLANK word  */
+#line 551 "parser.y"
+                                                {
+		(yyvsp[-3].redirect_un).red_e = add_word_to_list((yyvsp[0].word_un).first, (yyvsp[-3].redirect_un).red_e);
+		(yyvsp[-3].redirect_un).red_flags |= IO_ERR_APPEND;
+		(yyval.redirect_un) = (yyvsp[-3].redirect_un);
+	}
+#line 2181 "parser.tab.c"
     break;
 
-  case 39:
-#line 458 "parser.y"
-    {
-		(yyvsp[(1) - (4)].redirect_un).red_o = add_word_to_list((yyvsp[(4) - (4)].word_un), (yyvsp[(1) - (4)].redirect_un).red_o);
-		(yyvsp[(1) - (4)].redirect_un).red_flags |= IO_OUT_APPEND;
-		(yyval.redirect_un) = (yyvsp[(1) - (4)].redirect_un);
-	;}
+  case 39: /* redirect: redirect REDIRECT_APPEND_O BLANK word  */
+#line 557 "parser.y"
+                                                {
+		(yyvsp[-3].redirect_un).red_o = add_word_to_list((yyvsp[0].word_un).first, (yyvsp[-3].redirect_un).red_o);
+		(yyvsp[-3].redirect_un).red_flags |= IO_OUT_APPEND;
+		(yyval.redirect_un) = (yyvsp[-3].redirect_un);
+	}
+#line 2191 "parser.tab.c"
     break;
 
-  case 40:
-#line 464 "parser.y"
-    {
-		(yyvsp[(1) - (4)].redirect_un).red_i = add_word_to_list((yyvsp[(4) - (4)].word_un), (yyvsp[(1) - (4)].redirect_un).red_i);
-		(yyval.redirect_un) = (yyvsp[(1) - (4)].redirect_un);
-	;}
+  case 40: /* redirect: redirect indirect BLANK word  */
+#line 563 "parser.y"
+                                       {
+		if (!add_input((yyvsp[0].word_un).first, (yyvsp[-2].flags_un), &(yyvsp[-3].redirect_un), (yylsp[-2]).first_column))
+			YYERROR;
+		(yyval.redirect_un) = (yyvsp[-3].redirect_un);
+	}
+#line 2201 "parser.tab.c"
     break;
 
-  case 41:
-#line 468 "parser.y"
-    {
-		(yyvsp[(1) - (5)].redirect_un).red_o = add_word_to_list((yyvsp[(4) - (5)].word_un), (yyvsp[(1) - (5)].redirect_un).red_o);
-		(yyvsp[(1) - (5)].redirect_un).red_e = add_word_to_list((yyvsp[(4) - (5)].word_un), (yyvsp[(1) - (5)].redirect_un).red_e);
-		(yyval.redirect_un) = (yyvsp[(1) - (5)].redirect_un);
-	;}
+  case 41: /* redirect: redirect REDIRECT_OE BLANK word BLANK  */
+#line 568 "parser.y"
+                                                {
+		(yyvsp[-4].redirect_un).red_o = add_word_to_list((yyvsp[-1].word_un).first, (yyvsp[-4].redirect_un).red_o);
+		(yyvsp[-4].redirect_un).red_e = add_word_to_list((yyvsp[-1].word_un).first, (yyvsp[-4].redirect_un).red_e);
+		(yyval.redirect_un) = (yyvsp[-4].redirect_un);
+	}
+#line 2211 "parser.tab.c"
     break;
 
-  case 42:
-#line 474 "parser.y"
-    {
-		(yyvsp[(1) - (5)].redirect_un).red_e = add_word_to_list((yyvsp[(4) - (5)].word_un), (yyvsp[(1) - (5)].redirect_un).red_e);
-		(yyval.redirect_un) = (yyvsp[(1) - (5)].redirect_un);
-	;}
+  case 42: /* redirect: redirect REDIRECT_E BLANK word BLANK  */
+#line 574 "parser.y"
+                                               {
+		(yyvsp[-4].redirect_un).red_e = add_word_to_list((yyvsp[-1].word_un).first, (yyvsp[-4].redirect_un).red_e);
+		(yyval.redirect_un) = (yyvsp[-4].redirect_un);
+	}
+#line 2220 "parser.tab.c"
     break;
 
-  case 43:
-#line 479 "parser.y"
-    {
-		(yyvsp[(1) - (5)].redirect_un).red_o = add_word_to_list((yyvsp[(4) - (5)].word_un), (yyvsp[(1) - (5)].redirect_un).red_o);
-		(yyval.redirect_un) = (yyvsp[(1) - (5)].redirect_un);
-	;}
+  case 43: /* redirect: redirect REDIRECT_O BLANK word BLANK  */
+#line 579 "parser.y"
+                                               {
+		(yyvsp[-4].redirect_un).red_o = add_word_to_list((yyvsp[-1].word_un).first, (yyvsp[-4].redirect_un).red_o);
+		(yyval.redirect_un) = (yyvsp[-4].redirect_un);
+	}
+#line 2229 "parser.tab.c"
     break;
 
-  case 44:
-#line 484 "parser.y"
-    {
-		(yyvsp[(1) - (5)].redirect_un).red_o = add_word_to_list((yyvsp[(4) - (5)].word_un), (yyvsp[(1) - (5)].redirect_un).red_o);
-		(yyvsp[(1) - (5)].redirect_un).red_flags |= IO_OUT_APPEND;
-		(yyval.redirect_un) = (yyvsp[(1) - (5)].redirect_un);
-	;}
+  case 44: /* redirect: redirect REDIRECT_APPEND_O BLANK word BLANK  */
+#line 584 "parser.y"
+                                                      {
+		(yyvsp[-4].redirect_un).red_o = add_word_to_list((yyvsp[-1].word_un).first, (yyvsp[-4].redirect_un).red_o);
+		(yyvsp[-4].redirect_un).red_flags |= IO_OUT_APPEND;
+		(yyval.redirect_un) = (yyvsp[-4].redirect_un);
+	}
+#line 2239 "parser.tab.c"
     break;
 
-  case 45:
-#line 490 "parser.y"
-    {
-		(yyvsp[(1) - (5)].redirect_un).red_o = add_word_to_list((yyvsp[(4) - (5)].word_un), (yyvsp[(1) - (5)].redirect_un).red_o);
-		(yyvsp[(1) - (5)].redirect_un).red_flags |= IO_ERR_APPEND;
-		(yyval.redirect_un) = (yyvsp[(1) - (5)].redirect_un);
-	;}
+  case 45: /* redirect: redirect REDIRECT_APPEND_E BLANK word BLANK  */
+#line 590 "parser.y"
+                                                      {
+		(yyvsp[-4].redirect_un).red_o = add_word_to_list((yyvsp[-1].word_un).first, (yyvsp[-4].redirect_un).red_o);
+		(yyvsp[-4].redirect_un).red_flags |= IO_ERR_APPEND;
+		(yyval.redirect_un) = (yyvsp[-4].redirect_un);
+	}
+#line 2249 "parser.tab.c"
     break;
 
-  case 46:
-#line 496 "parser.y"
-    {
-		(yyvsp[(1) - (5)].redirect_un).red_i = add_word_to_list((yyvsp[(4) - (5)].word_un), (yyvsp[(1) - (5)].redirect_un).red_i);
-		(yyval.redirect_un) = (yyvsp[(1) - (5)].redirect_un);
-	;}
+  case 46: /* redirect: redirect indirect BLANK word BLANK  */
+#line 596 "parser.y"
+                                             {
+		if (!add_input((yyvsp[-1].word_un).first, (yyvsp[-3].flags_un), &(yyvsp[-4].redirect_un), (yylsp[-3]).first_column))
+			YYERROR;
+		(yyval.redirect_un) = (yyvsp[-4].redirect_un);
+	}
+#line 2259 "parser.tab.c"
     break;
 
-  case 47:
-#line 505 "parser.y"
-    {
-		(yyval.word_un) = add_part_to_word(new_word((yyvsp[(2) - (2)].string_un), false), (yyvsp[(1) - (2)].word_un));
-	;}
+  case 47: /* indirect: INDIRECT  */
+#line 606 "parser.y"
+                   {
+		(yyval.flags_un) = IO_REGULAR;
+	}
+#line 2267 "parser.tab.c"
     break;
 
-  case 48:
-#line 509 "parser.y"
-    {
-		(yyval.word_un) = add_part_to_word(new_word((yyvsp[(2) - (2)].string_un), true), (yyvsp[(1) - (2)].word_un));
-	;}
+  case 48: /* indirect: HERE_DOC  */
+#line 610 "parser.y"
+                   {
+		(yyval.flags_un) = IO_HERE_DOC;
+	}
+#line 2275 "parser.tab.c"
     break;
 
-  case 49:
-#line 513 "parser.y"
-    {
-		(yyval.word_un) = new_word((yyvsp[(1) - (1)].string_un), false);
-	;}
+  case 49: /* indirect: HERE_STRING  */
+#line 614 "parser.y"
+                      {
+		(yyval.flags_un) = IO_HERE_STRING;
+	}
+#line 2283 "parser.tab.c"
     break;
 
-  case 50:
-#line 517 "parser.y"
-    {
-		(yyval.word_un) = new_word((yyvsp[(1) - (1)].string_un), true);
-	;}
+  case 50: /* word: word WORD  */
+#line 622 "parser.y"
+                    {
+		(yyval.word_un) = add_part_to_word(new_word((yyvsp[0].string_un), false), (yyvsp[-1].word_un));
+	}
+#line 2291 "parser.tab.c"
     break;
 
+  case 51: /* word: word ENV_VAR  */
+#line 626 "parser.y"
+                       {
+		(yyval.word_un) = add_part_to_word(new_word((yyvsp[0].string_un), true), (yyvsp[-1].word_un));
+	}
+#line 2299 "parser.tab.c"
+    break;
+
+  case 52: /* word: WORD  */
+#line 630 "parser.y"
+               {
+		(yyval.word_un) = new_list(new_word((yyvsp[0].string_un), false));
+	}
+#line 2307 "parser.tab.c"
+    break;
+
+  case 53: /* word: ENV_VAR  */
+#line 634 "parser.y"
+                  {
+		(yyval.word_un) = new_list(new_word((yyvsp[0].string_un), true));
+	}
+#line 2315 "parser.tab.c"
+    break;
+
+
+#line 2319 "parser.tab.c"
 
-/* Line 1267 of yacc.c.  */
-#line 2080 "parser.tab.c"
       default: break;
     }
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
   YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
 
   *++yyvsp = yyval;
   *++yylsp = yyloc;
 
-  /* Now `shift' the result of the reduction.  Determine what state
+  /* Now 'shift' the result of the reduction.  Determine what state
      that goes to, based on the state we popped back to and the rule
      number reduced by.  */
-
-  yyn = yyr1[yyn];
-
-  yystate = yypgoto[yyn - YYNTOKENS] + *yyssp;
-  if (0 <= yystate && yystate <= YYLAST && yycheck[yystate] == *yyssp)
-    yystate = yytable[yystate];
-  else
-    yystate = yydefgoto[yyn - YYNTOKENS];
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
 
   goto yynewstate;
 
 
-/*------------------------------------.
-| yyerrlab -- here on detecting error |
-`------------------------------------*/
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
 yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
     {
       ++yynerrs;
-#if ! YYERROR_VERBOSE
-      yyerror (YY_("syntax error"));
-#else
       {
-	YYSIZE_T yysize = yysyntax_error (0, yystate, yychar);
-	if (yymsg_alloc < yysize && yymsg_alloc < YYSTACK_ALLOC_MAXIMUM)
-	  {
-	    YYSIZE_T yyalloc = 2 * yysize;
-	    if (! (yysize <= yyalloc && yyalloc <= YYSTACK_ALLOC_MAXIMUM))
-	      yyalloc = YYSTACK_ALLOC_MAXIMUM;
-	    if (yymsg != yymsgbuf)
-	      YYSTACK_FREE (yymsg);
-	    yymsg = (char *) YYSTACK_ALLOC (yyalloc);
-	    if (yymsg)
-	      yymsg_alloc = yyalloc;
-	    else
-	      {
-		yymsg = yymsgbuf;
-		yymsg_alloc = sizeof yymsgbuf;
-	      }
-	  }
-
-	if (0 < yysize && yysize <= yymsg_alloc)
-	  {
-	    (void) yysyntax_error (yymsg, yystate, yychar);
-	    yyerror (yymsg);
-	  }
-	else
-	  {
-	    yyerror (YY_("syntax error"));
-	    if (yysize != 0)
-	      goto yyexhaustedlab;
-	  }
+        yypcontext_t yyctx
+          = {yyssp, yytoken, &yylloc};
+        char const *yymsgp = YY_("syntax error");
+        int yysyntax_error_status;
+        yysyntax_error_status = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+        if (yysyntax_error_status == 0)
+          yymsgp = yymsg;
+        else if (yysyntax_error_status == -1)
+          {
+            if (yymsg != yymsgbuf)
+              YYSTACK_FREE (yymsg);
+            yymsg = YY_CAST (char *,
+                             YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
+            if (yymsg)
+              {
+                yysyntax_error_status
+                  = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+                yymsgp = yymsg;
+              }
+            else
+              {
+                yymsg = yymsgbuf;
+                yymsg_alloc = sizeof yymsgbuf;
+                yysyntax_error_status = YYENOMEM;
+              }
+          }
+        yyerror (&yylloc, lexer, root, yymsgp);
+        if (yysyntax_error_status == YYENOMEM)
+          YYNOMEM;
       }
-#endif
     }
 
-  yyerror_range[0] = yylloc;
-
+  yyerror_range[1] = yylloc;
   if (yyerrstatus == 3)
     {
-      /* If just tried and failed to reuse look-ahead token after an
-	 error, discard it.  */
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
 
       if (yychar <= YYEOF)
-	{
-	  /* Return failure if at end of input.  */
-	  if (yychar == YYEOF)
-	    YYABORT;
-	}
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
       else
-	{
-	  yydestruct ("Error: discarding",
-		      yytoken, &yylval, &yylloc);
-	  yychar = YYEMPTY;
-	}
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval, &yylloc, lexer, root);
+          yychar = YYEMPTY;
+        }
     }
 
-  /* Else will try to reuse look-ahead token after shifting the error
+  /* Else will try to reuse lookahead token after shifting the error
      token.  */
   goto yyerrlab1;
 
@@ -2178,15 +2425,13 @@ yyerrlab:
 | yyerrorlab -- error raised explicitly by YYERROR.  |
 `---------------------------------------------------*/
 yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
 
-  /* Pacify compilers like GCC when the user code never invokes
-     YYERROR and the label yyerrorlab therefore never appears in user
-     code.  */
-  if (/*CONSTCOND*/ 0)
-     goto yyerrorlab;
-
-  yyerror_range[0] = yylsp[1-yylen];
-  /* Do not reclaim the symbols of the rule which action triggered
+  /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
   YYPOPSTACK (yylen);
   yylen = 0;
@@ -2199,47 +2444,45 @@ yyerrorlab:
 | yyerrlab1 -- common code for both syntax error and YYERROR.  |
 `-------------------------------------------------------------*/
 yyerrlab1:
-  yyerrstatus = 3;	/* Each real token shifted decrements this.  */
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
     {
       yyn = yypact[yystate];
-      if (yyn != YYPACT_NINF)
-	{
-	  yyn += YYTERROR;
-	  if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
-	    {
-	      yyn = yytable[yyn];
-	      if (0 < yyn)
-		break;
-	    }
-	}
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
 
       /* Pop the current state because it cannot handle the error token.  */
       if (yyssp == yyss)
-	YYABORT;
+        YYABORT;
 
-      yyerror_range[0] = *yylsp;
+      yyerror_range[1] = *yylsp;
       yydestruct ("Error: popping",
-		  yystos[yystate], yyvsp, yylsp);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, yylsp, lexer, root);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
     }
 
-  if (yyn == YYFINAL)
-    YYACCEPT;
-
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 
-  yyerror_range[1] = yylloc;
-  /* Using YYLLOC is tempting, but would change the location of
-     the look-ahead.  YYLOC is available though.  */
-  YYLLOC_DEFAULT (yyloc, (yyerror_range - 1), 2);
-  *++yylsp = yyloc;
+  yyerror_range[2] = yylloc;
+  ++yylsp;
+  YYLLOC_DEFAULT (*yylsp, yyerror_range, 2);
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
@@ -2250,58 +2493,77 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
 /*-----------------------------------.
 | yyabortlab -- YYABORT comes here.  |
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
 
-#ifndef yyoverflow
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
-  yyerror (YY_("memory exhausted"));
+  yyerror (&yylloc, lexer, root, YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
 
-yyreturn:
-  if (yychar != YYEOF && yychar != YYEMPTY)
-     yydestruct ("Cleanup: discarding lookahead",
-		 yytoken, &yylval, &yylloc);
-  /* Do not reclaim the symbols of the rule which action triggered
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval, &yylloc, lexer, root);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
      this YYABORT or YYACCEPT.  */
   YYPOPSTACK (yylen);
   YY_STACK_PRINT (yyss, yyssp);
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-		  yystos[*yyssp], yyvsp, yylsp);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, yylsp, lexer, root);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
   if (yyss != yyssa)
     YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
   if (yymsg != yymsgbuf)
     YYSTACK_FREE (yymsg);
-#endif
-  /* Make sure YYID is used.  */
-  return YYID (yyresult);
+  return yyresult;
 }
 
-
-#line 522 "parser.y"
+#line 639 "parser.y"
 
 
 
 bool parse_line(const char * line, command_t ** root)
 {
+	if (line == NULL) {
+		/* see the comment in parser.h */
+		assert(false);
+		return false;
+	}
+
+	return parse_line_n(line, strlen(line), root);
+}
+
+
+bool parse_line_n(const char * line, size_t length, command_t ** root)
+{
+	lexer_t lexer;
+
 	if (*root != NULL) {
 		/* see the comment in parser.h */
 		assert(false);
@@ -2315,20 +2577,15 @@ bool parse_line(const char * line, command_t ** root)
 	}
 
 	free_parse_memory();
-	globalParseAnotherString(line);
+	lexerStart(&lexer, line, length);
 	needsFree = true;
-	command_root = NULL;
 
-	yylloc.first_line = yylloc.last_line = 1;
-	yylloc.first_column = yylloc.last_column = 0;
-
-	if (yyparse() != 0) {
+	if (yyparse(&lexer, root) != 0) {
 		/* yyparse failed */
+		*root = NULL;
 		return false;
 	}
 
-	*root = command_root;
-
 	return true;
 }
 
@@ -2336,27 +2593,13 @@ bool parse_line(const char * line, command_t ** root)
 void free_parse_memory()
 {
 	if (needsFree) {
-		globalEndParsing();
-		while (globalAllocCount != 0) {
-			globalAllocCount--;
-			assert(globalAllocMem[globalAllocCount] != NULL);
-			free(globalAllocMem[globalAllocCount]);
-			globalAllocMem[globalAllocCount] = NULL;
-		}
-
-		if (globalAllocMem != NULL) {
-			free((void *)globalAllocMem);
-			globalAllocMem = NULL;
-		}
-
-		globalAllocSize = 0;
+		arenaReset();
 		needsFree = false;
 	}
 }
 
 
-void yyerror(const char* str)
+void yyerror(YYLTYPE * llocp, lexer_t * lexer, command_t ** root, const char * str)
 {
-	parse_error(str, yylloc.first_column);
+	parse_error(str, llocp->first_column);
 }
-
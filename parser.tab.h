@@ -1,14 +1,14 @@
-/* A Bison parser, made by GNU Bison 2.3.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
-/* Skeleton interface for Bison's Yacc-like parsers in C
+/* Bison interface for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989, 1990, 2000, 2001, 2002, 2003, 2004, 2005, 2006
-   Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
-   This program is free software; you can redistribute it and/or modify
+   This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
-   the Free Software Foundation; either version 2, or (at your option)
-   any later version.
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
 
    This program is distributed in the hope that it will be useful,
    but WITHOUT ANY WARRANTY; without even the implied warranty of
@@ -16,9 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program; if not, write to the Free Software
-   Foundation, Inc., 51 Franklin Street, Fifth Floor,
-   Boston, MA 02110-1301, USA.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -33,92 +31,105 @@
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
-/* Tokens.  */
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_YY_PARSER_TAB_H_INCLUDED
+# define YY_YY_PARSER_TAB_H_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
-   /* Put the tokens into the symbol table, so that GDB and other debuggers
-      know about them.  */
-   enum yytokentype {
-     NOT_ACCEPTED_CHAR = 258,
-     INVALID_ENVIRONMENT_VAR = 259,
-     UNEXPECTED_EOF = 260,
-     CHARS_AFTER_EOL = 261,
-     END_OF_FILE = 262,
-     END_OF_LINE = 263,
-     BLANK = 264,
-     REDIRECT_OE = 265,
-     REDIRECT_O = 266,
-     REDIRECT_E = 267,
-     INDIRECT = 268,
-     REDIRECT_APPEND_E = 269,
-     REDIRECT_APPEND_O = 270,
-     WORD = 271,
-     ENV_VAR = 272,
-     SEQUENTIAL = 273,
-     PARALLEL = 274,
-     CONDITIONAL_ZERO = 275,
-     CONDITIONAL_NZERO = 276,
-     PIPE = 277
-   };
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    NOT_ACCEPTED_CHAR = 258,       /* NOT_ACCEPTED_CHAR  */
+    INVALID_ENVIRONMENT_VAR = 259, /* INVALID_ENVIRONMENT_VAR  */
+    UNEXPECTED_EOF = 260,          /* UNEXPECTED_EOF  */
+    CHARS_AFTER_EOL = 261,         /* CHARS_AFTER_EOL  */
+    END_OF_FILE = 262,             /* END_OF_FILE  */
+    END_OF_LINE = 263,             /* END_OF_LINE  */
+    BLANK = 264,                   /* BLANK  */
+    REDIRECT_OE = 265,             /* REDIRECT_OE  */
+    REDIRECT_O = 266,              /* REDIRECT_O  */
+    REDIRECT_E = 267,              /* REDIRECT_E  */
+    INDIRECT = 268,                /* INDIRECT  */
+    HERE_DOC = 269,                /* HERE_DOC  */
+    HERE_STRING = 270,             /* HERE_STRING  */
+    REDIRECT_APPEND_E = 271,       /* REDIRECT_APPEND_E  */
+    REDIRECT_APPEND_O = 272,       /* REDIRECT_APPEND_O  */
+    WORD = 273,                    /* WORD  */
+    ENV_VAR = 274,                 /* ENV_VAR  */
+    SEQUENTIAL = 275,              /* SEQUENTIAL  */
+    PARALLEL = 276,                /* PARALLEL  */
+    CONDITIONAL_NZERO = 277,       /* CONDITIONAL_NZERO  */
+    CONDITIONAL_ZERO = 278,        /* CONDITIONAL_ZERO  */
+    PIPE = 279                     /* PIPE  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
-/* Tokens.  */
-#define NOT_ACCEPTED_CHAR 258
-#define INVALID_ENVIRONMENT_VAR 259
-#define UNEXPECTED_EOF 260
-#define CHARS_AFTER_EOL 261
-#define END_OF_FILE 262
-#define END_OF_LINE 263
-#define BLANK 264
-#define REDIRECT_OE 265
-#define REDIRECT_O 266
-#define REDIRECT_E 267
-#define INDIRECT 268
-#define REDIRECT_APPEND_E 269
-#define REDIRECT_APPEND_O 270
-#define WORD 271
-#define ENV_VAR 272
-#define SEQUENTIAL 273
-#define PARALLEL 274
-#define CONDITIONAL_ZERO 275
-#define CONDITIONAL_NZERO 276
-#define PIPE 277
-
-
-
 
+/* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE
-#line 221 "parser.y"
+union YYSTYPE
 {
+#line 315 "parser.y"
+
 	command_t * command_un;
 	const char * string_un;
 	redirect_t redirect_un;
 	simple_command_t * simple_command_un;
 	word_t * exe_un;
-	word_t * params_un;
-	word_t * word_un;
-}
-/* Line 1489 of yacc.c.  */
-#line 103 "parser.tab.h"
-	YYSTYPE;
-# define yystype YYSTYPE /* obsolescent; will be withdrawn */
-# define YYSTYPE_IS_DECLARED 1
+	word_list_t params_un;
+	word_list_t word_un;
+	int flags_un;
+
+#line 99 "parser.tab.h"
+
+};
+typedef union YYSTYPE YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
 #endif
 
-extern YYSTYPE yylval;
-
+/* Location type.  */
 #if ! defined YYLTYPE && ! defined YYLTYPE_IS_DECLARED
-typedef struct YYLTYPE
+typedef struct YYLTYPE YYLTYPE;
+struct YYLTYPE
 {
   int first_line;
   int first_column;
   int last_line;
   int last_column;
-} YYLTYPE;
-# define yyltype YYLTYPE /* obsolescent; will be withdrawn */
+};
 # define YYLTYPE_IS_DECLARED 1
 # define YYLTYPE_IS_TRIVIAL 1
 #endif
 
-extern YYLTYPE yylloc;
+
+
+
+int yyparse (lexer_t * lexer, command_t ** root);
+
+/* "%code provides" blocks.  */
+#line 297 "parser.y"
+
+
+/* the lexer, in parser.lex.c */
+int yylex(YYSTYPE * lvalp, YYLTYPE * llocp, lexer_t * lexer);
+
+
+#line 134 "parser.tab.h"
+
+#endif /* !YY_YY_PARSER_TAB_H_INCLUDED  */
@@ -1,6 +1,9 @@
 %defines
-%error-verbose
+%define parse.error verbose
+%define api.pure full
 %locations
+%lex-param {lexer_t * lexer}
+%parse-param {lexer_t * lexer} {command_t ** root}
 %{
 
 
@@ -34,74 +37,120 @@ using namespace std;
 #include "parser.h"
 
 
-static GenericPointer * globalAllocMem = NULL;
-static size_t globalAllocCount = 0;
-static size_t globalAllocSize  = 0;
-static bool needsFree = false;
-static command_t * command_root = NULL;
+/*
+ all the memory of a parse (parse tree nodes and token strings) is taken
+ from an arena: a list of blocks that are never freed one by one;
+ free_parse_memory() only rewinds the arena, so the next line reuses
+ the same blocks
+*/
+
+#define ARENA_BLOCK_SIZE	(64 * 1024)
+#define ARENA_ALIGN		(sizeof(void *))
 
+typedef struct arenaBlock {
+	struct arenaBlock * next;
+	size_t size;
+	size_t used;
+} arenaBlock;
 
-void yyerror(const char* str);
+static arenaBlock * arenaFirst = NULL;
+static arenaBlock * arenaCurrent = NULL;
+static bool needsFree = false;
 
 
-static void ensureSize(size_t newSize)
+static char * blockData(arenaBlock * block)
 {
-	GenericPointer * newPtr;
-	assert(newSize > 0);
-
-	if (globalAllocSize == 0) {
-		assert(globalAllocMem == NULL);
-		globalAllocSize = newSize;
-		globalAllocMem = (GenericPointer *)malloc(sizeof(GenericPointer) * globalAllocSize);
-		if (globalAllocMem == NULL) {
-			fprintf(stderr, "malloc() failed\n");
-			exit(EXIT_FAILURE);
-		}
+	/* the data follows the (aligned) header */
+	return (char *)block + ((sizeof(arenaBlock) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1));
+}
 
-		return;
-	}
 
-	assert(globalAllocMem != NULL);
-	if (globalAllocSize >= newSize) {
-		return;
+static arenaBlock * newBlock(size_t size)
+{
+	arenaBlock * block;
+
+	if (size < ARENA_BLOCK_SIZE) {
+		size = ARENA_BLOCK_SIZE;
 	}
 
-	globalAllocSize += newSize;
-	newPtr = (GenericPointer *)realloc((void *)globalAllocMem, sizeof(GenericPointer) * globalAllocSize);
-	if (newPtr == NULL) {
-		fprintf(stderr, "realloc() failed\n");
+	block = (arenaBlock *)malloc((blockData(NULL) - (char *)NULL) + size);
+	if (block == NULL) {
+		fprintf(stderr, "malloc() failed\n");
 		exit(EXIT_FAILURE);
 	}
 
-	globalAllocMem = newPtr;
+	block->next = NULL;
+	block->size = size;
+	block->used = 0;
+
+	return block;
 }
 
 
-void pointerToMallocMemory(const void * ptr)
+void * parserAlloc(size_t size)
 {
-	if (ptr == NULL) {
-		fprintf(stderr, "malloc() failed\n");
-		exit(EXIT_FAILURE);
+	void * ptr;
+	assert(size > 0);
+
+	size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+
+	if (arenaCurrent == NULL) {
+		assert(arenaFirst == NULL);
+		arenaFirst = arenaCurrent = newBlock(size);
+	}
+
+	/* blocks after the current one are left over from a previous parse */
+	while (arenaCurrent->size - arenaCurrent->used < size) {
+		if (arenaCurrent->next == NULL) {
+			arenaCurrent->next = newBlock(size);
+		}
+		arenaCurrent = arenaCurrent->next;
+		arenaCurrent->used = 0;
 	}
 
-	ensureSize(globalAllocCount + 1);
-	globalAllocMem[globalAllocCount++] = (GenericPointer)ptr;
+	ptr = blockData(arenaCurrent) + arenaCurrent->used;
+	arenaCurrent->used += size;
+	/* also when the tree was not parsed (see parserStrndup) */
+	needsFree = true;
+
+	return ptr;
+}
+
+
+char * parserStrndup(const char * str, size_t length)
+{
+	char * copy = (char *)parserAlloc(length + 1);
+
+	memcpy(copy, str, length);
+	copy[length] = '\0';
+
+	return copy;
+}
+
+
+static void arenaReset()
+{
+	if (arenaFirst != NULL) {
+		arenaCurrent = arenaFirst;
+		arenaCurrent->used = 0;
+	}
 }
 
 
 static simple_command_t * bind_parts(word_t * exe_name, word_t * params, redirect_t red)
 {
-	simple_command_t * s = (simple_command_t *) malloc(sizeof(simple_command_t));
-	pointerToMallocMemory(s);
+	simple_command_t * s = (simple_command_t *) parserAlloc(sizeof(simple_command_t));
 
 	memset(s, 0, sizeof(*s));
 	assert(exe_name != NULL);
 	assert(exe_name->next_word == NULL);
 	s->verb = exe_name;
 	s->params = params;
-	s->in = red.red_i;
-	s->out = red.red_o;
-	s->err = red.red_e;
+	s->in = red.red_i.first;
+	s->out = red.red_o.first;
+	s->err = red.red_e.first;
+	s->here = red.red_here;
+	s->here_doc = NULL;
 	s->io_flags = red.red_flags;
 	s->up = NULL;
 	s->aux = NULL;
@@ -111,8 +160,7 @@ static simple_command_t * bind_parts(word_t * exe_name, word_t * params, redirec
 
 static command_t * new_command(simple_command_t * scmd)
 {
-	command_t * c = (command_t *) malloc(sizeof(command_t));
-	pointerToMallocMemory(c);
+	command_t * c = (command_t *) parserAlloc(sizeof(command_t));
 
 	memset(c, 0, sizeof(*c));
 	c->up = c->cmd1 = c->cmd2 = NULL;
@@ -127,8 +175,7 @@ static command_t * new_command(simple_command_t * scmd)
 
 static command_t * bind_commands(command_t * cmd1, command_t * cmd2, operator_t op)
 {
-	command_t * c = (command_t *) malloc(sizeof(command_t));
-	pointerToMallocMemory(c);
+	command_t * c = (command_t *) parserAlloc(sizeof(command_t));
 
 	memset(c, 0, sizeof(*c));
 	c->up = NULL;
@@ -152,8 +199,7 @@ static command_t * bind_commands(command_t * cmd1, command_t * cmd2, operator_t
 
 static word_t * new_word(const char * str, bool expand)
 {
-	word_t * w = (word_t *) malloc(sizeof(word_t));
-	pointerToMallocMemory(w);
+	word_t * w = (word_t *) parserAlloc(sizeof(word_t));
 
 	memset(w, 0, sizeof(*w));
 	assert(str != NULL);
@@ -166,24 +212,25 @@ static word_t * new_word(const char * str, bool expand)
 }
 
 
-static word_t * add_part_to_word(word_t * w, word_t * lst)
+static word_list_t new_list(word_t * w)
 {
-	word_t * crt = lst;
-	assert(lst != NULL);
-	assert(w != NULL);
+	word_list_t lst;
 
-	/*
-	 we could insert at the beginnig and then invert the list
-	 but this would make the code a bit more complicated
-	 thus, we assume we have small lists and O(n*n) is acceptable
-	*/
+	lst.first = w;
+	lst.last = w;
 
-	while (crt->next_part != NULL) {
-		crt = crt->next_part;
-		assert((crt == NULL) || (crt->next_word == NULL));
-	}
+	return lst;
+}
 
-	crt->next_part = w;
+
+static word_list_t add_part_to_word(word_t * w, word_list_t lst)
+{
+	assert(lst.last != NULL);
+	assert(lst.last->next_part == NULL);
+	assert(w != NULL);
+
+	lst.last->next_part = w;
+	lst.last = w;
 	assert(w->next_part == NULL);
 	assert(w->next_word == NULL);
 
@@ -191,47 +238,95 @@ static word_t * add_part_to_word(word_t * w, word_t * lst)
 }
 
 
-static word_t * add_word_to_list(word_t * w, word_t * lst)
+static word_list_t add_word_to_list(word_t * w, word_list_t lst)
 {
-	word_t * crt = lst;
 	assert(w != NULL);
 
-	if (crt == NULL) {
+	if (lst.first == NULL) {
 		assert(w->next_word == NULL);
-		return w;
+		return new_list(w);
 	}
-	assert(lst != NULL);
+	assert(lst.last != NULL);
 
 	/*
-	 same as above
+	 the word after &> is on both the red_o and the red_e lists, so
+	 appending to one list appends to the other one too; the last word
+	 is not always the last one then, but it is on the list, before the
+	 words appended since
 	*/
-	while (crt->next_word != NULL) {
-		crt = crt->next_word;
+	while (lst.last->next_word != NULL) {
+		lst.last = lst.last->next_word;
 	}
 
-	crt->next_word = w;
+	lst.last->next_word = w;
+	lst.last = w;
 	assert(w->next_word == NULL);
 
 	return lst;
 }
 
 
+/*
+ adds w to the input redirections of red: a file (kind IO_REGULAR), the
+ delimiter of a here-document (IO_HERE_DOC) or a here-string
+ (IO_HERE_STRING)
+ returns false (after reporting the error, found at column where) for a
+ second here-document or here-string, which the shell would not know
+ where to read from
+*/
+static bool add_input(word_t * w, int kind, redirect_t * red, int where)
+{
+	if (kind == IO_REGULAR) {
+		red->red_i = add_word_to_list(w, red->red_i);
+		return true;
+	}
+
+	if (red->red_here != NULL) {
+		parse_error("more than one here-document or here-string", where);
+		return false;
+	}
+
+	red->red_here = w;
+	red->red_flags |= kind;
+	return true;
+}
+
+
 %}
 
+%code provides {
+
+/* the lexer, in parser.lex.c */
+int yylex(YYSTYPE * lvalp, YYLTYPE * llocp, lexer_t * lexer);
+
+}
+
+%code {
+
+void yyerror(YYLTYPE * llocp, lexer_t * lexer, command_t ** root, const char * str);
+
+}
+
+%initial-action {
+	@$.first_line = @$.last_line = 1;
+	@$.first_column = @$.last_column = 0;
+}
+
 %union {
 	command_t * command_un;
 	const char * string_un;
 	redirect_t redirect_un;
 	simple_command_t * simple_command_un;
 	word_t * exe_un;
-	word_t * params_un;
-	word_t * word_un;
+	word_list_t params_un;
+	word_list_t word_un;
+	int flags_un;
 }
 
 
 %token NOT_ACCEPTED_CHAR INVALID_ENVIRONMENT_VAR UNEXPECTED_EOF CHARS_AFTER_EOL
 %token END_OF_FILE END_OF_LINE BLANK
-%token REDIRECT_OE REDIRECT_O REDIRECT_E INDIRECT
+%token REDIRECT_OE REDIRECT_O REDIRECT_E INDIRECT HERE_DOC HERE_STRING
 %token REDIRECT_APPEND_E REDIRECT_APPEND_O
 %token <string_un> WORD
 %token <string_un> ENV_VAR
@@ -247,6 +342,7 @@ static word_t * add_word_to_list(word_t * w, word_t * lst)
 %type <redirect_un> redirect
 %type <simple_command_un> simple_command
 %type <word_un> word
+%type <flags_un> indirect
 
 %start command_tree
 
@@ -255,32 +351,32 @@ static word_t * add_word_to_list(word_t * w, word_t * lst)
 command_tree:
 	
 	  command END_OF_LINE {
-		command_root = $1;
+		*root = $1;
 		YYACCEPT;
 	}
 	
 	| command END_OF_FILE {
-		command_root = $1;
+		*root = $1;
 		YYACCEPT;
 	}
 	
 	| END_OF_LINE {
-		command_root = NULL;
+		*root = NULL;
 		YYACCEPT;
 	}
 	
 	| END_OF_FILE {
-		command_root = NULL;
+		*root = NULL;
 		YYACCEPT;
 	}
 	
 	| BLANK END_OF_LINE {
-		command_root = NULL;
+		*root = NULL;
 		YYACCEPT;
 	}
 	
 	| BLANK END_OF_FILE {
-		command_root = NULL;
+		*root = NULL;
 		YYACCEPT;
 	}
 	
@@ -317,11 +413,11 @@ command:
 simple_command:
 	
 	  exe_name BLANK params redirect {
-		$$ = bind_parts($1, $3, $4);
+		$$ = bind_parts($1, $3.first, $4);
 	}
 	
 	| exe_name BLANK params BLANK redirect {
-		$$ = bind_parts($1, $3, $5);
+		$$ = bind_parts($1, $3.first, $5);
 	}
 	
 	| exe_name redirect {
@@ -337,11 +433,11 @@ simple_command:
 exe_name:
 	
 	  word {
-		$$ = $1;
+		$$ = $1.first;
 	}
 	
 	| BLANK word {
-		$$ = $2;
+		$$ = $2.first;
 	}
 	
 	;
@@ -349,156 +445,177 @@ exe_name:
 params:
 	
 	  params BLANK word {
-		$$ = add_word_to_list($3, $1);
-		assert($$ == $1);
+		$$ = add_word_to_list($3.first, $1);
+		assert($$.first == $1.first);
 	}
 	
 	| word {
-		$$ = $1;
+		$$ = new_list($1.first);
 	}
 	;
 	
 redirect:
 	
 	  { /* empty */
-		$$.red_o = NULL;
-		$$.red_i = NULL;
-		$$.red_e = NULL;
+		$$.red_o = new_list(NULL);
+		$$.red_i = new_list(NULL);
+		$$.red_e = new_list(NULL);
+		$$.red_here = NULL;
 		$$.red_flags = IO_REGULAR;
 	}
 	
 	| redirect REDIRECT_OE word {
-		$1.red_o = add_word_to_list($3, $1.red_o);
-		$1.red_e = add_word_to_list($3, $1.red_e);
+		$1.red_o = add_word_to_list($3.first, $1.red_o);
+		$1.red_e = add_word_to_list($3.first, $1.red_e);
 		$$ = $1;
 	}
 	
 	| redirect REDIRECT_E word {
-		$1.red_e = add_word_to_list($3, $1.red_e);
+		$1.red_e = add_word_to_list($3.first, $1.red_e);
 		$$ = $1;
 	}
 	
 	| redirect REDIRECT_O word {
-		$1.red_o = add_word_to_list($3, $1.red_o);
+		$1.red_o = add_word_to_list($3.first, $1.red_o);
 		$$ = $1;
 	}
 	
 	| redirect REDIRECT_APPEND_E word {
-		$1.red_e = add_word_to_list($3, $1.red_e);
+		$1.red_e = add_word_to_list($3.first, $1.red_e);
 		$1.red_flags |= IO_ERR_APPEND;
 		$$ = $1;
 	}
 	
 	| redirect REDIRECT_APPEND_O word {
-		$1.red_o = add_word_to_list($3, $1.red_o);
+		$1.red_o = add_word_to_list($3.first, $1.red_o);
 		$1.red_flags |= IO_OUT_APPEND;
 		$$ = $1;
 	}
 
-	| redirect INDIRECT word {
-		$1.red_i = add_word_to_list($3, $1.red_i);
+	| redirect indirect word {
+		if (!add_input($3.first, $2, &$1, @2.first_column))
+			YYERROR;
 		$$ = $1;
 	}
 	
 	| redirect REDIRECT_OE word BLANK {
-		$1.red_o = add_word_to_list($3, $1.red_o);
-		$1.red_e = add_word_to_list($3, $1.red_e);
+		$1.red_o = add_word_to_list($3.first, $1.red_o);
+		$1.red_e = add_word_to_list($3.first, $1.red_e);
 		$$ = $1;
 	}
 	
 	| redirect REDIRECT_E word BLANK {
-		$1.red_e = add_word_to_list($3, $1.red_e);
+		$1.red_e = add_word_to_list($3.first, $1.red_e);
 		$$ = $1;
 	}
 	
 	| redirect REDIRECT_O word BLANK {
-		$1.red_o = add_word_to_list($3, $1.red_o);
+		$1.red_o = add_word_to_list($3.first, $1.red_o);
 		$$ = $1;
 	}
 	
 	| redirect REDIRECT_APPEND_E word BLANK {
-		$1.red_e = add_word_to_list($3, $1.red_e);
+		$1.red_e = add_word_to_list($3.first, $1.red_e);
 		$1.red_flags |= IO_ERR_APPEND;
 		$$ = $1;
 	}
 	
 	| redirect REDIRECT_APPEND_O word BLANK {
-		$1.red_o = add_word_to_list($3, $1.red_o);
+		$1.red_o = add_word_to_list($3.first, $1.red_o);
 		$1.red_flags |= IO_OUT_APPEND;
 		$$ = $1;
 	}
 
-	| redirect INDIRECT word BLANK {
-		$1.red_i = add_word_to_list($3, $1.red_i);
+	| redirect indirect word BLANK {
+		if (!add_input($3.first, $2, &$1, @2.first_column))
+			YYERROR;
 		$$ = $1;
 	}
 	
 	| redirect REDIRECT_OE BLANK word {
-		$1.red_o = add_word_to_list($4, $1.red_o);
-		$1.red_e = add_word_to_list($4, $1.red_e);
+		$1.red_o = add_word_to_list($4.first, $1.red_o);
+		$1.red_e = add_word_to_list($4.first, $1.red_e);
 		$$ = $1;
 	}
 	
 	| redirect REDIRECT_E BLANK word {
-		$1.red_e = add_word_to_list($4, $1.red_e);
+		$1.red_e = add_word_to_list($4.first, $1.red_e);
 		$$ = $1;
 	}
 	
 	| redirect REDIRECT_O BLANK word {
-		$1.red_o = add_word_to_list($4, $1.red_o);
+		$1.red_o = add_word_to_list($4.first, $1.red_o);
 		$$ = $1;
 	}
 	
 	| redirect REDIRECT_APPEND_E BLANK word {
-		$1.red_e = add_word_to_list($4, $1.red_e);
+		$1.red_e = add_word_to_list($4.first, $1.red_e);
 		$1.red_flags |= IO_ERR_APPEND;
 		$$ = $1;
 	}
 	
 	| redirect REDIRECT_APPEND_O BLANK word {
-		$1.red_o = add_word_to_list($4, $1.red_o);
+		$1.red_o = add_word_to_list($4.first, $1.red_o);
 		$1.red_flags |= IO_OUT_APPEND;
 		$$ = $1;
 	}
 	
-	| redirect INDIRECT BLANK word {
-		$1.red_i = add_word_to_list($4, $1.red_i);
+	| redirect indirect BLANK word {
+		if (!add_input($4.first, $2, &$1, @2.first_column))
+			YYERROR;
 		$$ = $1;
 	}
 	| redirect REDIRECT_OE BLANK word BLANK {
-		$1.red_o = add_word_to_list($4, $1.red_o);
-		$1.red_e = add_word_to_list($4, $1.red_e);
+		$1.red_o = add_word_to_list($4.first, $1.red_o);
+		$1.red_e = add_word_to_list($4.first, $1.red_e);
 		$$ = $1;
 	}
 	
 	| redirect REDIRECT_E BLANK word BLANK {
-		$1.red_e = add_word_to_list($4, $1.red_e);
+		$1.red_e = add_word_to_list($4.first, $1.red_e);
 		$$ = $1;
 	}
 	
 	| redirect REDIRECT_O BLANK word BLANK {
-		$1.red_o = add_word_to_list($4, $1.red_o);
+		$1.red_o = add_word_to_list($4.first, $1.red_o);
 		$$ = $1;
 	}
 
 	| redirect REDIRECT_APPEND_O BLANK word BLANK {
-		$1.red_o = add_word_to_list($4, $1.red_o);
+		$1.red_o = add_word_to_list($4.first, $1.red_o);
 		$1.red_flags |= IO_OUT_APPEND;
 		$$ = $1;
 	}
 
 	| redirect REDIRECT_APPEND_E BLANK word BLANK {
-		$1.red_o = add_word_to_list($4, $1.red_o);
+		$1.red_o = add_word_to_list($4.first, $1.red_o);
 		$1.red_flags |= IO_ERR_APPEND;
 		$$ = $1;
 	}
 
-	| redirect INDIRECT BLANK word BLANK {
-		$1.red_i = add_word_to_list($4, $1.red_i);
+	| redirect indirect BLANK word BLANK {
+		if (!add_input($4.first, $2, &$1, @2.first_column))
+			YYERROR;
 		$$ = $1;
 	}
 	
 	;
+
+indirect:
+
+	  INDIRECT {
+		$$ = IO_REGULAR;
+	}
+
+	| HERE_DOC {
+		$$ = IO_HERE_DOC;
+	}
+
+	| HERE_STRING {
+		$$ = IO_HERE_STRING;
+	}
+
+	;
 	
 word:
 	
@@ -511,11 +628,11 @@ word:
 	}
 	
 	| WORD {
-		$$ = new_word($1, false);
+		$$ = new_list(new_word($1, false));
 	}
 	
 	| ENV_VAR {
-		$$ = new_word($1, true);
+		$$ = new_list(new_word($1, true));
 	}
 	
 	;
@@ -524,6 +641,20 @@ word:
 
 bool parse_line(const char * line, command_t ** root)
 {
+	if (line == NULL) {
+		/* see the comment in parser.h */
+		assert(false);
+		return false;
+	}
+
+	return parse_line_n(line, strlen(line), root);
+}
+
+
+bool parse_line_n(const char * line, size_t length, command_t ** root)
+{
+	lexer_t lexer;
+
 	if (*root != NULL) {
 		/* see the comment in parser.h */
 		assert(false);
@@ -537,20 +668,15 @@ bool parse_line(const char * line, command_t ** root)
 	}
 
 	free_parse_memory();
-	globalParseAnotherString(line);
+	lexerStart(&lexer, line, length);
 	needsFree = true;
-	command_root = NULL;
-
-	yylloc.first_line = yylloc.last_line = 1;
-	yylloc.first_column = yylloc.last_column = 0;
 
-	if (yyparse() != 0) {
+	if (yyparse(&lexer, root) != 0) {
 		/* yyparse failed */
+		*root = NULL;
 		return false;
 	}
 
-	*root = command_root;
-
 	return true;
 }
 
@@ -558,26 +684,13 @@ bool parse_line(const char * line, command_t ** root)
 void free_parse_memory()
 {
 	if (needsFree) {
-		globalEndParsing();
-		while (globalAllocCount != 0) {
-			globalAllocCount--;
-			assert(globalAllocMem[globalAllocCount] != NULL);
-			free(globalAllocMem[globalAllocCount]);
-			globalAllocMem[globalAllocCount] = NULL;
-		}
-
-		if (globalAllocMem != NULL) {
-			free((void *)globalAllocMem);
-			globalAllocMem = NULL;
-		}
-
-		globalAllocSize = 0;
+		arenaReset();
 		needsFree = false;
 	}
 }
 
 
-void yyerror(const char* str)
+void yyerror(YYLTYPE * llocp, lexer_t * lexer, command_t ** root, const char * str)
 {
-	parse_error(str, yylloc.first_column);
+	parse_error(str, llocp->first_column);
 }
@@ -0,0 +1,353 @@
+/******************************************************************************
+ * Mini Shell in Linux - pipelines implementation
+ *****************************************************************************/
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/stat.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "minternals.h"
+#include "pipeline.h"
+#include "redirect.h"
+#include "utils.h"
+
+
+
+/**
+ * Size of the pipes of a chain that grew with use, and the chain it is for.
+ */
+typedef struct {
+  uint64_t key;  /* chain_key of the chain */
+  int size;
+} pipe_tuning_t;
+
+static bool size_set;     /* -p was given */
+static int  size_option;
+static int  max_size;     /* Limit of the system, once read */
+
+/* Chains that grew, by their key modulo PIPELINE_TUNED */
+static pipe_tuning_t tuned[PIPELINE_TUNED];
+
+
+
+/* Declarations */
+static int      chosen_size ();
+static int      limit_size  (int size);
+static uint64_t chain_key   (command_t *c);
+static uint64_t hash_command(command_t *c, uint64_t hash);
+static uint64_t hash_words  (word_t *w, uint64_t hash);
+static uint64_t hash_bytes  (const void *bytes, size_t length, uint64_t hash);
+static int      count_stages(command_t *c);
+static void     add_stages  (command_t *c, pipeline_t *p);
+
+static bool is_cat      (simple_command_t *s);
+static int  open_source (simple_command_t *s);
+static void drop_stage  (pipeline_t *p, int i);
+
+
+
+/**
+ * Collect the stages of the pipe chain rooted at c.
+ */
+void pipeline_collect(command_t *c, pipeline_t *p) {
+  p->stages = calloc(count_stages(c), sizeof(command_t *));
+  if (p->stages == NULL) {
+    mfatal(ERR_ALLOCATION);
+  }
+  p->count = 0;
+  p->in_fd = -1;
+
+  add_stages(c, p);
+}
+
+/**
+ * Drop the cat stages that only copy bytes from one stage to the next.
+ */
+void pipeline_optimize(pipeline_t *p) {
+  int i;
+
+  /* a | cat | b: connect a to b directly */
+  for (i = p->count - 2; i > 0; i--) {
+    simple_command_t *s = p->stages[i]->scmd;
+    if (is_cat(s) && s->params == NULL && s->in == NULL) {
+      drop_stage(p, i);
+    }
+  }
+
+  /* cat file | b: let b read the file */
+  if (p->count > 1 && p->in_fd < 0 && is_cat(p->stages[0]->scmd)) {
+    p->in_fd = open_source(p->stages[0]->scmd);
+    if (p->in_fd >= 0) {
+      drop_stage(p, 0);
+    }
+  }
+}
+
+/**
+ * Release the memory held by p (not the stages themselves).
+ */
+void pipeline_free(pipeline_t *p) {
+  if (p->in_fd >= 0) {
+    close(p->in_fd);
+    p->in_fd = -1;
+  }
+  free(p->stages);
+  p->stages = NULL;
+  p->count = 0;
+}
+
+/**
+ * A size for the pipes of a chain.
+ */
+int pipeline_parse_size(const char *value) {
+  char *end;
+
+  if (strncmp(value, "auto", strlen("auto")) == 0) {
+    end = (char *)value + strlen("auto");
+    return *end == 0 || *end == ',' ? PIPELINE_SIZE_AUTO : 0;
+  }
+
+  unsigned long size = strtoul(value, &end, 10);
+  if (end == value) {
+    return 0;
+  }
+  if (*end == 'k' || *end == 'K') {
+    size <<= 10;
+    end++;
+  } else if (*end == 'm' || *end == 'M') {
+    size <<= 20;
+    end++;
+  }
+
+  if ((*end != 0 && *end != ',') || size > INT_MAX) {
+    return 0;
+  }
+  return (int)size;
+}
+
+/**
+ * Size the pipes of every chain.
+ */
+void pipeline_set_pipe_size(int size) {
+  size_set = true;
+  size_option = size;
+}
+
+/**
+ * Size for the pipes of the chain rooted at c.
+ */
+int pipeline_pipe_size(command_t *c) {
+  int size = chosen_size();
+
+  if (size != PIPELINE_SIZE_AUTO) {
+    return size > 0 ? limit_size(size) : 0;
+  }
+
+  uint64_t key = chain_key(c);
+  pipe_tuning_t *tuning = &tuned[key % PIPELINE_TUNED];
+  return tuning->size != 0 && tuning->key == key ? tuning->size : 0;
+}
+
+/**
+ * The chain rooted at c is over.
+ */
+void pipeline_observe(command_t *c, long switches) {
+  if (switches < PIPELINE_BLOCKING || chosen_size() != PIPELINE_SIZE_AUTO) {
+    return;
+  }
+
+  uint64_t key = chain_key(c);
+  pipe_tuning_t *tuning = &tuned[key % PIPELINE_TUNED];
+  if (tuning->size == 0 || tuning->key != key) {
+    /* First growth, or the slot held another chain: start over */
+    tuning->key = key;
+    tuning->size = PIPELINE_DEFAULT_SIZE;
+  }
+
+  tuning->size = limit_size(tuning->size < INT_MAX / PIPELINE_GROWTH
+                            ? tuning->size * PIPELINE_GROWTH : INT_MAX);
+}
+
+
+
+/**
+ * The size given by -p or, without it, by the pipe= hint.
+ */
+static int chosen_size() {
+  redirect_hints_t hints;
+
+  if (size_set) {
+    return size_option;
+  }
+
+  redirect_hints(&hints);
+  return hints.pipe_size;
+}
+
+/**
+ * size, at most the limit of the system on the size of a pipe.
+ */
+static int limit_size(int size) {
+  if (max_size == 0) {
+    FILE *f = fopen(PIPELINE_MAX_SIZE_PATH, "re");
+    if (f == NULL || fscanf(f, "%d", &max_size) != 1 ||
+        max_size < PIPELINE_DEFAULT_SIZE) {
+      max_size = PIPELINE_DEFAULT_SIZE;
+    }
+    if (f != NULL) {
+      fclose(f);
+    }
+  }
+
+  return size < max_size ? size : max_size;
+}
+
+/**
+ * What tells the chain rooted at c from others: a hash of its text (words,
+ * operators and redirections), so that it is found again when the line is
+ * parsed anew.
+ */
+static uint64_t chain_key(command_t *c) {
+  return hash_command(c, 0);
+}
+
+/**
+ * Add the command rooted at c to hash.
+ */
+static uint64_t hash_command(command_t *c, uint64_t hash) {
+  hash = hash_bytes(&c->op, sizeof(c->op), hash);
+
+  if (c->op != OP_NONE) {
+    return hash_command(c->cmd2, hash_command(c->cmd1, hash));
+  }
+
+  simple_command_t *s = c->scmd;
+  hash = hash_bytes(&s->io_flags, sizeof(s->io_flags), hash);
+  hash = hash_words(s->verb, hash);
+  hash = hash_words(s->params, hash);
+  hash = hash_words(s->in, hash);
+  hash = hash_words(s->out, hash);
+  hash = hash_words(s->err, hash);
+  return hash_words(s->here, hash);
+}
+
+/**
+ * Add a list of words to hash, with the bounds of its parts and words.
+ */
+static uint64_t hash_words(word_t *w, uint64_t hash) {
+  word_t *part;
+
+  for (; w != NULL; w = w->next_word) {
+    for (part = w; part != NULL; part = part->next_part) {
+      hash = hash_bytes(part->string, strlen(part->string) + 1, hash);
+      hash = hash_bytes(&part->expand, sizeof(part->expand), hash);
+    }
+    hash = hash_bytes("", 1, hash);
+  }
+
+  return hash_bytes("", 1, hash);
+}
+
+/**
+ * hash, followed by length bytes.
+ */
+static uint64_t hash_bytes(const void *bytes, size_t length, uint64_t hash) {
+  uint64_t pair[2] = { hash, fnv1a(bytes, length) };
+
+  return fnv1a(pair, sizeof(pair));
+}
+
+/**
+ * Number of simple commands in the pipe chain rooted at c.
+ */
+static int count_stages(command_t *c) {
+  if (c->op != OP_PIPE) {
+    return 1;
+  }
+  return count_stages(c->cmd1) + count_stages(c->cmd2);
+}
+
+/**
+ * Append the stages of c to p, in the order they appear in the command line.
+ */
+static void add_stages(command_t *c, pipeline_t *p) {
+  if (c->op != OP_PIPE) {
+    p->stages[p->count++] = c;
+    return;
+  }
+  add_stages(c->cmd1, p);
+  add_stages(c->cmd2, p);
+}
+
+/**
+ * Check whether s is a plain cat with no output or error redirection, and
+ * no here-document or here-string.
+ */
+static bool is_cat(simple_command_t *s) {
+  word_t *verb = s->verb;
+
+  return verb->expand == false && verb->next_part == NULL &&
+         strcmp(verb->string, "cat") == 0 && s->out == NULL &&
+         s->err == NULL && s->here == NULL;
+}
+
+/**
+ * Open the single file a cat stage would copy (cat < file, cat file).
+ * Returns -1 when there is no such file or it is not a regular file.
+ */
+static int open_source(simple_command_t *s) {
+  word_t *source;
+
+  if (s->params == NULL && s->in != NULL) {
+    source = s->in;
+  } else if (s->params != NULL && s->params->next_word == NULL &&
+             s->in == NULL) {
+    source = s->params;
+  } else {
+    return -1;
+  }
+
+  char *filename = get_word(source);
+  if (filename == NULL) {
+    return -1;
+  }
+
+  /* Options, and '-' for the standard input, are left to cat */
+  int fd = -1;
+  if (filename[0] != '-') {
+    fd = open(filename, O_RDONLY | O_CLOEXEC);
+  }
+  free(filename);
+
+  struct stat st;
+  if (fd >= 0 && (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))) {
+    close(fd);
+    fd = -1;
+  }
+
+  if (fd >= 0) {
+    /* It now takes the place of an input redirection */
+    redirect_hints_t hints;
+    redirect_hints(&hints);
+    redirect_advise_input(fd, &hints);
+  }
+
+  return fd;
+}
+
+/**
+ * Remove stage i from p.
+ */
+static void drop_stage(pipeline_t *p, int i) {
+  mlog("dropping cat stage %d of %d", i, p->count);
+  memmove(p->stages + i, p->stages + i + 1,
+          (p->count - i - 1) * sizeof(command_t *));
+  p->count--;
+}
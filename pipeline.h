@@ -0,0 +1,94 @@
+/******************************************************************************
+ * Mini Shell in Linux - pipelines
+ *****************************************************************************/
+
+#ifndef _PIPELINE_H
+#define _PIPELINE_H
+
+#include "parser.h"
+
+/* Size of the pipes of a chain that grows with use (-p auto, or pipe=auto in
+ * REDIRECT_HINTS_VAR) */
+#define PIPELINE_SIZE_AUTO (-1)
+
+/* Size of a new pipe, and the largest one when the limit of the system
+ * cannot be read from PIPELINE_MAX_SIZE_PATH */
+#define PIPELINE_DEFAULT_SIZE (64 * 1024)
+#define PIPELINE_MAX_SIZE_PATH "/proc/sys/fs/pipe-max-size"
+
+/* A stage that blocked this many times (voluntary context switches) makes
+ * the pipes of its chain PIPELINE_GROWTH times larger the next time */
+#define PIPELINE_BLOCKING 256
+#define PIPELINE_GROWTH   4
+
+/* Chains whose pipes grew that are remembered at a time */
+#define PIPELINE_TUNED 64
+
+/**
+ * A chain of OP_PIPE nodes flattened into its stages, left to right.
+ * Every stage is an OP_NONE node (see the comment for command_t in parser.h).
+ *
+ * in_fd, when not -1, is a file the first stage reads instead of the
+ * standard input of the shell (left behind by pipeline_optimize).
+ */
+typedef struct {
+  command_t **stages;
+  int count;
+  int in_fd;
+} pipeline_t;
+
+/**
+ * Collect the stages of the pipe chain rooted at c.
+ */
+void pipeline_collect(command_t *c, pipeline_t *p);
+
+/**
+ * Drop the cat stages that only copy bytes from one stage to the next:
+ *   a | cat | b        ->  a | b
+ *   cat < file | b     ->  b, reading file
+ *   cat file | b       ->  b, reading file
+ * The last stage is never dropped, since it gives the status of the chain.
+ * A file is only handed over when it can be opened and is a regular file;
+ * otherwise the stage is kept so that cat reports the error.
+ */
+void pipeline_optimize(pipeline_t *p);
+
+/**
+ * Release the memory held by p (not the stages themselves).
+ */
+void pipeline_free(pipeline_t *p);
+
+/**
+ * A size for the pipes of a chain, written as a number of bytes with an
+ * optional k or m suffix, or auto (PIPELINE_SIZE_AUTO), and ending with the
+ * string or at a ','. Returns 0 if it is neither.
+ */
+int pipeline_parse_size(const char *value);
+
+/**
+ * Size the pipes of every chain (-p): a number of bytes, PIPELINE_SIZE_AUTO,
+ * or 0 for the default. Without it, the size comes from the pipe= hint of
+ * REDIRECT_HINTS_VAR.
+ */
+void pipeline_set_pipe_size(int size);
+
+/**
+ * Size for the pipes of the chain rooted at c, at most the limit of the
+ * system, or 0 to leave them as they are. With PIPELINE_SIZE_AUTO, every
+ * chain starts at PIPELINE_DEFAULT_SIZE and is grown by pipeline_observe.
+ * The size it reached is kept by the text of the chain, not in its tree, so
+ * the chain finds it again when it runs from a tree parsed anew (a line out
+ * of the cache, with a here-document or from a compiled script), and
+ * identical chains share it. Up to PIPELINE_TUNED chains are remembered; one
+ * whose slot is taken by another starts over.
+ */
+int pipeline_pipe_size(command_t *c);
+
+/**
+ * The chain rooted at c is over; switches is the largest number of voluntary
+ * context switches among its stages. When its size grows with use and a
+ * stage kept blocking on its pipes, the next run gets larger ones.
+ */
+void pipeline_observe(command_t *c, long switches);
+
+#endif
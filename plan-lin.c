@@ -0,0 +1,306 @@
+/******************************************************************************
+ * Mini Shell in Linux - command plans implementation
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fcntl.h>
+
+#include "minternals.h"
+#include "plan.h"
+#include "utils.h"
+
+
+
+/* Declarations */
+static plan_t     *compile       (simple_command_t *s);
+static void        measure_word  (word_t *w, int *segments, size_t *bytes,
+                                  bool *literal);
+static void        compile_word  (plan_t *p, int index, word_t *w,
+                                  char **strings);
+static const char *segment_value (const plan_segment_t *seg);
+static size_t      word_length   (plan_t *p, int index);
+static char       *expand_word   (plan_t *p, int index, char *to);
+static const char *redirect_word (plan_t *p, int index, char **to);
+
+
+
+/**
+ * Plan of s, compiled the first time it is needed.
+ */
+plan_t *plan_get(simple_command_t *s) {
+  if (s->aux == NULL) {
+    s->aux = compile(s);
+  }
+  return s->aux;
+}
+
+/**
+ * Fill args by expanding the variables of p.
+ */
+void plan_expand(plan_t *p, plan_args_t *args) {
+  args->out_flags = p->out_flags;
+  args->err_flags = p->err_flags;
+
+  if (p->literal) {
+    args->block = NULL;
+    args->argv  = p->argv;
+    args->in    = redirect_word(p, p->argc + PLAN_IN, NULL);
+    args->out   = redirect_word(p, p->argc + PLAN_OUT, NULL);
+    args->err   = redirect_word(p, p->argc + PLAN_ERR, NULL);
+    args->here  = redirect_word(p, p->argc + PLAN_HERE, NULL);
+  } else {
+    /* One block: the argument list, then the expanded words */
+    size_t size = (p->argc + 1) * sizeof(char *);
+    int i;
+    for (i = 0; i < p->argc + PLAN_IO_WORDS; i++) {
+      if (p->words[i].count > 0) {
+        size += word_length(p, i) + 1;
+      }
+    }
+
+    args->block = malloc(size);
+    if (args->block == NULL) {
+      mfatal(ERR_ALLOCATION);
+    }
+
+    args->argv = args->block;
+    char *to = (char *)(args->argv + p->argc + 1);
+    for (i = 0; i < p->argc; i++) {
+      args->argv[i] = to;
+      to = expand_word(p, i, to);
+    }
+    args->argv[p->argc] = NULL;
+
+    args->in  = redirect_word(p, p->argc + PLAN_IN, &to);
+    args->out = redirect_word(p, p->argc + PLAN_OUT, &to);
+    args->err = redirect_word(p, p->argc + PLAN_ERR, &to);
+    args->here = redirect_word(p, p->argc + PLAN_HERE, &to);
+  }
+
+  args->here_newline = args->here != NULL;
+  if (p->here_doc != NULL) {
+    args->here = p->here_doc;
+    args->here_newline = false;
+  }
+
+  args->err_to_out = (p->io_flags & (IO_OUT_APPEND | IO_ERR_APPEND)) == 0 &&
+                     args->out != NULL &&
+                     args->err != NULL && strcmp(args->out, args->err) == 0;
+}
+
+/**
+ * Release what plan_expand allocated.
+ */
+void plan_release(plan_args_t *args) {
+  free(args->block);
+  args->block = NULL;
+}
+
+/**
+ * Free the plans attached to the simple commands of the tree rooted at c.
+ */
+void plan_free_tree(command_t *c) {
+  if (c->op == OP_NONE) {
+    free(c->scmd->aux);
+    c->scmd->aux = NULL;
+    return;
+  }
+  free(c->aux);
+  c->aux = NULL;
+  plan_free_tree(c->cmd1);
+  plan_free_tree(c->cmd2);
+}
+
+
+
+/**
+ * Compile s into a plan; the plan and everything it points to is a single
+ * block, so that free(plan) releases it.
+ */
+static plan_t *compile(simple_command_t *s) {
+  word_t *here_string = (s->io_flags & IO_HERE_STRING) ? s->here : NULL;
+  word_t *words[PLAN_IO_WORDS] = { s->in, s->out, s->err, here_string };
+  word_t *w;
+  int argc = 0, segments = 0, i;
+  size_t bytes = 0;
+  bool literal = true;
+
+  for (w = s->verb; w != NULL; w = w->next_word) {
+    measure_word(w, &segments, &bytes, &literal);
+    argc++;
+  }
+  for (w = s->params; w != NULL; w = w->next_word) {
+    measure_word(w, &segments, &bytes, &literal);
+    argc++;
+  }
+  for (i = 0; i < PLAN_IO_WORDS; i++) {
+    if (words[i] != NULL) {
+      measure_word(words[i], &segments, &bytes, &literal);
+    }
+  }
+
+  size_t size = sizeof(plan_t) + segments * sizeof(plan_segment_t) +
+                (argc + 1) * sizeof(char *) +
+                (argc + PLAN_IO_WORDS) * sizeof(plan_word_t) + bytes;
+  plan_t *p = malloc(size);
+  if (p == NULL) {
+    mfatal(ERR_ALLOCATION);
+  }
+
+  p->argc     = argc;
+  p->literal  = literal;
+  p->segments = (plan_segment_t *)(p + 1);
+  p->argv     = (char **)(p->segments + segments);
+  p->words    = (plan_word_t *)(p->argv + argc + 1);
+  p->io_flags = s->io_flags;
+  p->here_doc = s->here_doc;
+
+  p->out_flags = O_WRONLY | O_CREAT |
+                 ((s->io_flags & IO_OUT_APPEND) ? O_APPEND : O_TRUNC);
+  p->err_flags = O_WRONLY | O_CREAT |
+                 ((s->io_flags & IO_ERR_APPEND) ? O_APPEND : O_TRUNC);
+
+  char *strings = (char *)(p->words + argc + PLAN_IO_WORDS);
+  segments = 0;
+  i = 0;
+  compile_word(p, i++, s->verb, &strings);
+  for (w = s->params; w != NULL; w = w->next_word) {
+    compile_word(p, i++, w, &strings);
+  }
+  compile_word(p, argc + PLAN_IN, s->in, &strings);
+  compile_word(p, argc + PLAN_OUT, s->out, &strings);
+  compile_word(p, argc + PLAN_ERR, s->err, &strings);
+  compile_word(p, argc + PLAN_HERE, here_string, &strings);
+
+  /* Without variables, the argument list is final */
+  for (i = 0; i < argc; i++) {
+    p->argv[i] = literal ? (char *)p->segments[p->words[i].first].string
+                         : NULL;
+  }
+  p->argv[argc] = NULL;
+
+  mlog("plan: argc %d, %s", argc, literal ? "literal" : "with variables");
+
+  return p;
+}
+
+/**
+ * Count the segments and string bytes of the parts of a word.
+ */
+static void measure_word(word_t *w, int *segments, size_t *bytes,
+    bool *literal) {
+  bool in_literal = false;
+
+  for (; w != NULL; w = w->next_part) {
+    if (w->expand || !in_literal) {
+      (*segments)++;
+      (*bytes)++; /* '\0' */
+    }
+    *bytes += strlen(w->string);
+    in_literal = !w->expand;
+    if (w->expand) {
+      *literal = false;
+    }
+  }
+}
+
+/**
+ * Compile the parts of w into the segments of word index of p; consecutive
+ * literal parts are concatenated. w may be NULL (no such redirection).
+ */
+static void compile_word(plan_t *p, int index, word_t *w, char **strings) {
+  plan_word_t *word = &p->words[index];
+  plan_segment_t *seg = NULL;
+
+  word->first = index == 0 ? 0 : p->words[index - 1].first +
+                                 p->words[index - 1].count;
+  word->count = 0;
+
+  for (; w != NULL; w = w->next_part) {
+    size_t length = strlen(w->string);
+
+    if (seg == NULL || w->expand || seg->expand) {
+      if (seg != NULL) {
+        (*strings)++; /* Terminate the previous segment */
+      }
+      seg = &p->segments[word->first + word->count++];
+      seg->string = *strings;
+      seg->length = 0;
+      seg->expand = w->expand;
+    }
+
+    memcpy(*strings, w->string, length);
+    *strings += length;
+    **strings = '\0';
+    seg->length += length;
+  }
+
+  if (seg != NULL) {
+    (*strings)++;
+  }
+}
+
+/**
+ * Value of a segment: its text, or the value of its variable.
+ */
+static const char *segment_value(const plan_segment_t *seg) {
+  if (!seg->expand) {
+    return seg->string;
+  }
+
+  return get_variable(seg->string);
+}
+
+/**
+ * Length of word index of p, once expanded.
+ */
+static size_t word_length(plan_t *p, int index) {
+  plan_segment_t *seg = &p->segments[p->words[index].first];
+  size_t length = 0;
+  int i;
+
+  for (i = 0; i < p->words[index].count; i++, seg++) {
+    length += seg->expand ? strlen(segment_value(seg)) : seg->length;
+  }
+
+  return length;
+}
+
+/**
+ * Write word index of p, expanded and '\0' terminated, at to. Returns the
+ * position after the terminator.
+ */
+static char *expand_word(plan_t *p, int index, char *to) {
+  plan_segment_t *seg = &p->segments[p->words[index].first];
+  int i;
+
+  for (i = 0; i < p->words[index].count; i++, seg++) {
+    const char *value = segment_value(seg);
+    size_t length = seg->expand ? strlen(value) : seg->length;
+    memcpy(to, value, length);
+    to += length;
+  }
+  *to++ = '\0';
+
+  return to;
+}
+
+/**
+ * A redirection word of p: NULL if absent, the literal itself when p has no
+ * variables (at == NULL), otherwise expanded at *at.
+ */
+static const char *redirect_word(plan_t *p, int index, char **at) {
+  if (p->words[index].count == 0) {
+    return NULL;
+  }
+  if (at == NULL) {
+    return p->segments[p->words[index].first].string;
+  }
+
+  const char *word = *at;
+  *at = expand_word(p, index, *at);
+  return word;
+}
@@ -0,0 +1,93 @@
+/******************************************************************************
+ * Mini Shell in Linux - command plans
+ *****************************************************************************/
+
+#ifndef _PLAN_H
+#define _PLAN_H
+
+#include <stddef.h>
+
+#include "parser.h"
+
+/**
+ * A run of a word: literal text (consecutive literal parts of the word are
+ * concatenated at compile time) or the name of a variable to expand.
+ */
+typedef struct {
+  const char *string;
+  size_t length;
+  bool expand;
+} plan_segment_t;
+
+/**
+ * A word, as a range of segments.
+ */
+typedef struct {
+  int first;
+  int count;
+} plan_word_t;
+
+/* Redirection words follow the argc argument words */
+#define PLAN_IN   0
+#define PLAN_OUT  1
+#define PLAN_ERR  2
+#define PLAN_HERE 3 /* The here-string */
+#define PLAN_IO_WORDS 4
+
+/**
+ * Compiled form of a simple command, stored in simple_command_t::aux.
+ * When no word needs expansion (literal == true), argv is the final
+ * argument list and nothing is computed when the command runs.
+ */
+typedef struct {
+  int argc;
+  bool literal;
+  char **argv;
+  plan_word_t *words;
+  plan_segment_t *segments;
+  int io_flags;
+  int out_flags;
+  int err_flags;
+  const char *here_doc; /* Text of the here-document, if any */
+} plan_t;
+
+/**
+ * The words of a plan, with variables expanded. in, out, err and here are
+ * NULL when there is no such redirection. All of it lives in a single block.
+ */
+typedef struct {
+  char **argv;
+  const char *in;
+  const char *out;
+  const char *err;
+  const char *here;   /* Here-document text or here-string, for stdin */
+  bool here_newline;  /* A here-string: a newline follows here */
+  bool err_to_out; /* cmd &> file: err shares the output file */
+  int out_flags;
+  int err_flags;
+  void *block;
+} plan_args_t;
+
+/**
+ * Plan of s, compiled and attached to s the first time it is needed.
+ */
+plan_t *plan_get(simple_command_t *s);
+
+/**
+ * Fill args by expanding the variables of p (at most one allocation).
+ */
+void plan_expand(plan_t *p, plan_args_t *args);
+
+/**
+ * Release what plan_expand allocated.
+ */
+void plan_release(plan_args_t *args);
+
+/**
+ * Free the plans attached to the simple commands of the tree rooted at c,
+ * and whatever the operator nodes hold in aux (one block each, such as a
+ * compiled chain_t).
+ */
+void plan_free_tree(command_t *c);
+
+#endif
@@ -0,0 +1,292 @@
+/******************************************************************************
+ * Mini Shell in Linux - child reaper implementation
+ *****************************************************************************/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/epoll.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+
+#include <unistd.h>
+
+#include "minternals.h"
+#include "reaper.h"
+#include "utils.h"
+
+/* Events taken from epoll at once */
+#define REAPER_EVENTS 16
+
+/**
+ * A child of the shell: running, or ended and not yet waited for.
+ */
+typedef struct {
+  pid_t pid;
+  int pidfd;           /* -1 once the child was collected */
+  bool done;
+  int status;
+  struct rusage usage;
+} job_t;
+
+
+
+/* Declarations */
+static job_t *find_job    (pid_t pid);
+static job_t *find_done   ();
+static void   remove_job  (job_t *j);
+static void   collect     ();
+static void   collect_job (job_t *j);
+static int    open_pidfd  (pid_t pid);
+
+static job_t *jobs;
+static int    jobs_count;
+static int    jobs_size;
+
+static int  epoll_fd = -1;
+static bool no_pidfd;      /* pidfd_open is not available */
+
+
+
+/**
+ * Start tracking the child pid.
+ */
+void reaper_add(pid_t pid) {
+  if (jobs_count == jobs_size) {
+    jobs_size = jobs_size == 0 ? 16 : 2 * jobs_size;
+    jobs = realloc(jobs, jobs_size * sizeof(job_t));
+    if (jobs == NULL) {
+      mfatal(ERR_ALLOCATION);
+    }
+  }
+
+  job_t *j = &jobs[jobs_count++];
+  memset(j, 0, sizeof(job_t));
+  j->pid = pid;
+  j->pidfd = -1;
+
+  if (no_pidfd) {
+    return;
+  }
+
+  if (epoll_fd < 0) {
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  }
+
+  j->pidfd = open_pidfd(pid);
+  if (j->pidfd >= 0) {
+    struct epoll_event event = { .events = EPOLLIN, .data.u64 = pid };
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, j->pidfd, &event) == 0) {
+      return;
+    }
+    close(j->pidfd);
+    j->pidfd = -1;
+  }
+
+  /* From now on every child is collected with wait4(-1) */
+  mlog("no pidfd for child %d: %s", pid, strerror(errno));
+  no_pidfd = true;
+  int i;
+  for (i = 0; i < jobs_count; i++) {
+    if (jobs[i].pidfd >= 0) {
+      close(jobs[i].pidfd);
+      jobs[i].pidfd = -1;
+    }
+  }
+}
+
+/**
+ * fork, tracking the child in the parent.
+ */
+pid_t reaper_fork() {
+  pid_t pid = fork();
+
+  if (pid > 0) {
+    reaper_add(pid);
+  } else if (pid == 0) {
+    /* The children of the parent are not ours to wait for */
+    int i;
+    for (i = 0; i < jobs_count; i++) {
+      if (jobs[i].pidfd >= 0) {
+        close(jobs[i].pidfd);
+      }
+    }
+    jobs_count = 0;
+
+    if (epoll_fd >= 0) {
+      close(epoll_fd);
+      epoll_fd = -1;
+    }
+  }
+
+  return pid;
+}
+
+/**
+ * Wait until the tracked child pid ends.
+ */
+int reaper_wait(pid_t pid, struct rusage *usage) {
+  job_t *j = find_job(pid);
+  int status = 0;
+
+  if (j == NULL) {
+    /* Not started through the reaper */
+    wait4(pid, &status, 0, usage);
+    return status;
+  }
+
+  while (!j->done) {
+    collect();
+    j = find_job(pid);
+  }
+
+  status = j->status;
+  if (usage != NULL) {
+    *usage = j->usage;
+  }
+  remove_job(j);
+
+  return status;
+}
+
+/**
+ * Wait until any tracked child ends.
+ */
+pid_t reaper_wait_any(int *status, struct rusage *usage) {
+  if (jobs_count == 0) {
+    return -1;
+  }
+
+  job_t *j;
+  while ((j = find_done()) == NULL) {
+    collect();
+  }
+
+  pid_t pid = j->pid;
+  if (status != NULL) {
+    *status = j->status;
+  }
+  if (usage != NULL) {
+    *usage = j->usage;
+  }
+  remove_job(j);
+
+  return pid;
+}
+
+
+
+/**
+ * Tracked child pid, or NULL.
+ */
+static job_t *find_job(pid_t pid) {
+  int i;
+
+  for (i = 0; i < jobs_count; i++) {
+    if (jobs[i].pid == pid) {
+      return &jobs[i];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * A tracked child that ended, or NULL.
+ */
+static job_t *find_done() {
+  int i;
+
+  for (i = 0; i < jobs_count; i++) {
+    if (jobs[i].done) {
+      return &jobs[i];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * Stop tracking a child (the last job takes its place).
+ */
+static void remove_job(job_t *j) {
+  if (j->pidfd >= 0) {
+    close(j->pidfd);
+  }
+
+  *j = jobs[--jobs_count];
+}
+
+/**
+ * Block until at least one tracked child ended and collect all those that
+ * did (or return early when interrupted by a signal).
+ */
+static void collect() {
+  if (no_pidfd) {
+    int status;
+    struct rusage usage;
+    pid_t pid = wait4(-1, &status, 0, &usage);
+    if (pid < 0) {
+      if (errno != EINTR) {
+        perror("Could not wait for child");
+        exit(EXIT_FAILURE);
+      }
+      return;
+    }
+
+    job_t *j = find_job(pid);
+    if (j != NULL) {
+      j->done = true;
+      j->status = status;
+      j->usage = usage;
+    }
+    return;
+  }
+
+  struct epoll_event events[REAPER_EVENTS];
+  int n = epoll_wait(epoll_fd, events, REAPER_EVENTS, -1);
+  if (n < 0) {
+    if (errno != EINTR) {
+      perror("Could not wait for child");
+      exit(EXIT_FAILURE);
+    }
+    return;
+  }
+
+  int i;
+  for (i = 0; i < n; i++) {
+    job_t *j = find_job((pid_t)events[i].data.u64);
+    if (j != NULL) {
+      collect_job(j);
+    }
+  }
+}
+
+/**
+ * Collect the child of j if it ended, closing its pidfd (which also takes
+ * it out of the epoll set).
+ */
+static void collect_job(job_t *j) {
+  pid_t pid = wait4(j->pid, &j->status, WNOHANG, &j->usage);
+
+  if (pid == j->pid || (pid < 0 && errno == ECHILD)) {
+    j->done = true;
+    close(j->pidfd);
+    j->pidfd = -1;
+  }
+}
+
+/**
+ * pidfd_open(2), which glibc did not wrap before 2.36. The pidfd is
+ * close-on-exec.
+ */
+static int open_pidfd(pid_t pid) {
+#ifdef SYS_pidfd_open
+  return syscall(SYS_pidfd_open, pid, 0);
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+}
@@ -0,0 +1,38 @@
+/******************************************************************************
+ * Mini Shell in Linux - child reaper
+ *****************************************************************************/
+
+#ifndef _REAPER_H
+#define _REAPER_H
+
+#include <sys/types.h>
+#include <sys/resource.h>
+
+/**
+ * Start tracking the child pid. Each child gets a pidfd, watched by one
+ * epoll instance: whichever child ends first is collected first, whatever
+ * the order the shell waits in. Without pidfd_open (Linux < 5.3) children
+ * are collected with wait4(-1) instead.
+ */
+void reaper_add(pid_t pid);
+
+/**
+ * fork, tracking the child in the parent. The child gets an empty job table
+ * of its own: it only waits for the children it starts.
+ */
+pid_t reaper_fork();
+
+/**
+ * Wait until the tracked child pid ends, collecting any other child that
+ * ends meanwhile. Returns its wait status; its resource usage goes to usage
+ * (when not NULL). The child is no longer tracked afterwards.
+ */
+int reaper_wait(pid_t pid, struct rusage *usage);
+
+/**
+ * Wait until any tracked child ends. Returns its pid (and status in status,
+ * usage in usage, when not NULL), or -1 if no child is tracked.
+ */
+pid_t reaper_wait_any(int *status, struct rusage *usage);
+
+#endif
@@ -0,0 +1,347 @@
+/******************************************************************************
+ * Mini Shell in Linux - redirections implementation
+ *****************************************************************************/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/stat.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "here.h"
+#include "minternals.h"
+#include "pipeline.h"
+#include "redirect.h"
+#include "utils.h"
+
+/* Flags that make two opens of the same device differ */
+#define REDIRECT_KEY_FLAGS (O_ACCMODE | O_APPEND)
+
+/**
+ * A redirection target kept open.
+ */
+typedef struct {
+  char *path;   /* NULL for a free slot */
+  int flags;    /* REDIRECT_KEY_FLAGS it was opened with */
+  int fd;
+  dev_t dev;
+  ino_t ino;
+  dev_t rdev;
+} target_t;
+
+
+
+/* Declarations */
+static int  redirect_in  (plan_args_t *args);
+static int  redirect_out (plan_args_t *args);
+static int  redirect_err (plan_args_t *args);
+static int  redirect_fd  (const char *path, int flags, int fd);
+static int  save_fd      (int fd);
+
+static bool cacheable    (const char *path);
+static bool same_file    (target_t *t, struct stat *st);
+static void drop_target  (target_t *t);
+
+static target_t targets[REDIRECT_CACHE_SIZE];
+static int next_slot;  /* Slot taken by the next target (round robin) */
+
+
+
+/**
+ * Apply the redirections of a command inside the shell.
+ */
+int redirect_push(redirect_frame_t *frame, plan_args_t *args) {
+  frame->saved[STDIN_FILENO] =
+      args->in != NULL || args->here != NULL ? save_fd(STDIN_FILENO) : -1;
+  frame->saved[STDOUT_FILENO] =
+      args->out != NULL ? save_fd(STDOUT_FILENO) : -1;
+  frame->saved[STDERR_FILENO] =
+      args->err != NULL || args->err_to_out ? save_fd(STDERR_FILENO) : -1;
+
+  return redirect_all(args);
+}
+
+/**
+ * Give the shell back the descriptors saved by redirect_push.
+ */
+void redirect_pop(redirect_frame_t *frame) {
+  int fd;
+
+  for (fd = STDIN_FILENO; fd <= STDERR_FILENO; fd++) {
+    if (frame->saved[fd] == -2) {
+      /* It was closed before */
+      close(fd);
+    } else if (frame->saved[fd] >= 0) {
+      dup2(frame->saved[fd], fd);
+      close(frame->saved[fd]);
+    }
+    frame->saved[fd] = -1;
+  }
+}
+
+/**
+ * Apply the redirections of a command.
+ */
+int redirect_all(plan_args_t *args) {
+  if (redirect_in(args) != 0 || redirect_out(args) != 0 ||
+      redirect_err(args) != 0) {
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * A descriptor open on path, as it would be with flags, or -1.
+ */
+int redirect_cached(const char *path, int flags) {
+  struct stat st;
+  int i;
+
+  if (!cacheable(path)) {
+    return -1;
+  }
+  flags &= REDIRECT_KEY_FLAGS;
+
+  for (i = 0; i < REDIRECT_CACHE_SIZE; i++) {
+    target_t *t = &targets[i];
+    if (t->path == NULL || t->flags != flags || strcmp(t->path, path) != 0) {
+      continue;
+    }
+
+    /* Still the same device under that name? */
+    if (stat(path, &st) == 0 && same_file(t, &st)) {
+      return t->fd;
+    }
+    drop_target(t);
+    break;
+  }
+
+  int fd = open(path, flags | O_CLOEXEC);
+  if (fd < 0) {
+    return -1;
+  }
+  if (fstat(fd, &st) != 0 || !S_ISCHR(st.st_mode)) {
+    close(fd);
+    return -1;
+  }
+
+  target_t *t = &targets[next_slot];
+  next_slot = (next_slot + 1) % REDIRECT_CACHE_SIZE;
+  drop_target(t);
+
+  t->path = strdup(path);
+  if (t->path == NULL) {
+    mfatal(ERR_ALLOCATION);
+  }
+  t->flags = flags;
+  t->fd = fd;
+  t->dev = st.st_dev;
+  t->ino = st.st_ino;
+  t->rdev = st.st_rdev;
+
+  return fd;
+}
+
+/**
+ * Read the hints from REDIRECT_HINTS_VAR.
+ */
+void redirect_hints(redirect_hints_t *hints) {
+  const char *value = getenv(REDIRECT_HINTS_VAR);
+
+  hints->sequential = false;
+  hints->noreuse = false;
+  hints->pipe_size = 0;
+
+  while (value != NULL && *value != 0) {
+    size_t length = strcspn(value, ",");
+
+    if (length == strlen("sequential") &&
+        strncmp(value, "sequential", length) == 0) {
+      hints->sequential = true;
+    } else if (length == strlen("noreuse") &&
+               strncmp(value, "noreuse", length) == 0) {
+      hints->noreuse = true;
+    } else if (strncmp(value, "pipe=", strlen("pipe=")) == 0) {
+      hints->pipe_size = pipeline_parse_size(value + strlen("pipe="));
+    }
+
+    value += length;
+    if (*value == ',') {
+      value++;
+    }
+  }
+}
+
+/**
+ * Check whether input files get any hint.
+ */
+bool redirect_hints_input(const redirect_hints_t *hints) {
+  return hints->sequential || hints->noreuse;
+}
+
+/**
+ * Give the kernel the hints about fd, a file about to be read.
+ */
+void redirect_advise_input(int fd, const redirect_hints_t *hints) {
+  if (hints->sequential) {
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+  }
+  if (hints->noreuse) {
+    posix_fadvise(fd, 0, 0, POSIX_FADV_NOREUSE);
+  }
+}
+
+/**
+ * In a child about to exec: make exec close every other descriptor.
+ */
+void redirect_close_others() {
+#if __GLIBC_PREREQ(2, 34)
+  /* Not fatal: on older kernels the descriptors simply stay open */
+  close_range(STDERR_FILENO + 1, ~0U, CLOSE_RANGE_CLOEXEC);
+#endif
+}
+
+
+
+/**
+ * Redirect input of a command
+ */
+static int redirect_in(plan_args_t *args) {
+  if (args->in != NULL) {
+    if (redirect_fd(args->in, O_RDONLY, STDIN_FILENO) != 0) {
+      perror("Could not open input file");
+      return -1;
+    }
+
+    redirect_hints_t hints;
+    redirect_hints(&hints);
+    redirect_advise_input(STDIN_FILENO, &hints);
+  }
+
+  if (args->here != NULL) {
+    int fd = here_open(args->here, args->here_newline);
+    if (fd < 0 || dup2(fd, STDIN_FILENO) < 0) {
+      perror("Could not create here-document");
+      if (fd >= 0) {
+        close(fd);
+      }
+      return -1;
+    }
+    close(fd);
+  }
+
+  return 0;
+}
+
+/**
+ * Redirect output of a command
+ */
+static int redirect_out(plan_args_t *args) {
+  if (args->out != NULL &&
+      redirect_fd(args->out, args->out_flags, STDOUT_FILENO) != 0) {
+    perror("Could not open output file");
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * Redirect error of a command
+ */
+static int redirect_err(plan_args_t *args) {
+  if (args->err == NULL) {
+    return 0;
+  }
+
+  if (args->err_to_out) {
+    if (dup2(STDOUT_FILENO, STDERR_FILENO) < 0) {
+      perror("Could not duplicate STDERR_FILENO");
+      return -1;
+    }
+    return 0;
+  }
+
+  if (redirect_fd(args->err, args->err_flags, STDERR_FILENO) != 0) {
+    perror("Could not open error file");
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * Open path with flags as descriptor fd.
+ */
+static int redirect_fd(const char *path, int flags, int fd) {
+  int new_fd = redirect_cached(path, flags);
+  if (new_fd >= 0) {
+    return dup2(new_fd, fd) < 0 ? -1 : 0;
+  }
+
+  new_fd = open(path, flags | O_CLOEXEC, IO_MODE);
+  if (new_fd < 0) {
+    return -1;
+  }
+
+  if (new_fd == fd) {
+    /* fd was closed: the file took its place, keep it across exec */
+    return fcntl(fd, F_SETFD, 0);
+  }
+
+  int rc = dup2(new_fd, fd);
+  close(new_fd);
+  return rc < 0 ? -1 : 0;
+}
+
+/**
+ * Put aside a copy of fd. Returns the copy, or -2 if fd is not open.
+ */
+static int save_fd(int fd) {
+  int copy = fcntl(fd, F_DUPFD_CLOEXEC, REDIRECT_FD_FLOOR);
+  if (copy < 0) {
+    if (errno != EBADF) {
+      perror("Could not save descriptor");
+      exit(EXIT_FAILURE);
+    }
+    return -2;
+  }
+  return copy;
+}
+
+/**
+ * Check whether path is one of REDIRECT_CACHE_PATHS.
+ */
+static bool cacheable(const char *path) {
+  static const char *paths[] = REDIRECT_CACHE_PATHS;
+  size_t i;
+
+  for (i = 0; i < sizeof(paths) / sizeof(paths[0]); i++) {
+    if (strcmp(path, paths[i]) == 0) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Check whether t is the file st describes.
+ */
+static bool same_file(target_t *t, struct stat *st) {
+  return S_ISCHR(st->st_mode) && st->st_dev == t->dev &&
+         st->st_ino == t->ino && st->st_rdev == t->rdev;
+}
+
+/**
+ * Close the target kept in t and free the slot.
+ */
+static void drop_target(target_t *t) {
+  if (t->path != NULL) {
+    close(t->fd);
+    free(t->path);
+    t->path = NULL;
+  }
+}
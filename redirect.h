@@ -0,0 +1,113 @@
+/******************************************************************************
+ * Mini Shell in Linux - redirections
+ *****************************************************************************/
+
+#ifndef _REDIRECT_H
+#define _REDIRECT_H
+
+#include "plan.h"
+
+/* Number of redirection targets kept open */
+#define REDIRECT_CACHE_SIZE 4
+
+/* Only these targets are kept open: devices that read and write the same
+ * way whatever process opens them (unlike /dev/stdout, /dev/tty, /dev/fd/N,
+ * which name descriptors of the process) */
+#define REDIRECT_CACHE_PATHS { "/dev/null", "/dev/zero", "/dev/full" }
+
+/* Saved descriptors of a redirect frame go at or above this one */
+#define REDIRECT_FD_FLOOR 10
+
+/* Environment variable with the hints given to the kernel about redirected
+ * streams, a comma-separated list of:
+ *   sequential  input files are read sequentially (larger read-ahead)
+ *   noreuse     input files are read once: their pages are not kept in the
+ *               page cache ahead of others
+ *   pipe=SIZE   pipes between the stages of a chain hold SIZE bytes (with an
+ *               optional k or m suffix) instead of 64 KB, or, with
+ *               pipe=auto, grow as their stages keep blocking (see
+ *               pipeline_pipe_size) */
+#define REDIRECT_HINTS_VAR "MINISHELL_REDIR_HINTS"
+
+/**
+ * Hints about redirected streams, from REDIRECT_HINTS_VAR.
+ */
+typedef struct {
+  bool sequential;
+  bool noreuse;
+  int pipe_size;  /* 0 for the default size, or PIPELINE_SIZE_AUTO */
+} redirect_hints_t;
+
+/**
+ * The standard descriptors a command running inside the shell (a builtin)
+ * redirected, and where the originals were put aside. Only the descriptors
+ * that are actually redirected are saved: a command without redirections
+ * costs no system call at all.
+ */
+typedef struct {
+  int saved[3];  /* Copy of 0, 1, 2; -1 if not redirected, -2 if closed */
+} redirect_frame_t;
+
+/**
+ * Apply the redirections of a command inside the shell, saving first the
+ * descriptors they replace (close-on-exec copies, at or above
+ * REDIRECT_FD_FLOOR). Whatever happens, call redirect_pop afterwards.
+ *
+ * Returns 0 on success, -1 (with the error printed) when a file could not be
+ * opened.
+ */
+int redirect_push(redirect_frame_t *frame, plan_args_t *args);
+
+/**
+ * Give the shell back the descriptors saved by redirect_push.
+ */
+void redirect_pop(redirect_frame_t *frame);
+
+/**
+ * Apply the redirections of a command (input, output, then error) to the
+ * standard descriptors of this process. Every file is opened close-on-exec
+ * and closed once duplicated, so nothing but 0, 1 and 2 is left behind.
+ *
+ * Returns 0 on success, -1 (with the error printed) when a file could not be
+ * opened.
+ */
+int redirect_all(plan_args_t *args);
+
+/**
+ * A descriptor open on path, as it would be with flags, that can be
+ * duplicated instead of opening path again; or -1.
+ *
+ * The character devices of REDIRECT_CACHE_PATHS are kept open after their
+ * first use; before being handed out again, such a
+ * descriptor is checked against the device path currently names (device and
+ * inode numbers). The descriptor belongs to the cache: it is close-on-exec
+ * and must not be closed.
+ */
+int redirect_cached(const char *path, int flags);
+
+/**
+ * Read the hints from REDIRECT_HINTS_VAR. It is read at every call, so that
+ * the shell itself may change it; unknown words are ignored.
+ */
+void redirect_hints(redirect_hints_t *hints);
+
+/**
+ * Check whether input files get any hint, in which case they have to be
+ * opened by the shell rather than by the command.
+ */
+bool redirect_hints_input(const redirect_hints_t *hints);
+
+/**
+ * Give the kernel the hints about fd, a file about to be read from start to
+ * end by a command. Failures (fd is not a regular file, the kernel does not
+ * know the hint) are ignored.
+ */
+void redirect_advise_input(int fd, const redirect_hints_t *hints);
+
+/**
+ * In a child about to exec: make exec close every descriptor but 0, 1 and 2,
+ * including those the shell itself inherited without close-on-exec.
+ */
+void redirect_close_others();
+
+#endif
@@ -0,0 +1,434 @@
+/******************************************************************************
+ * Mini Shell in Linux - compiled script cache implementation
+ *****************************************************************************/
+
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "input.h"
+#include "minternals.h"
+#include "script.h"
+#include "utils.h"
+
+#define SCRIPT_ALIGN  8
+#define ALIGN(n)      (((n) + SCRIPT_ALIGN - 1) & ~(uint64_t)(SCRIPT_ALIGN - 1))
+
+/**
+ * Start of a compiled script: the script it was compiled from, then the
+ * number of records that follow. The compact trees come after the records,
+ * each one aligned to SCRIPT_ALIGN.
+ */
+typedef struct {
+  uint32_t magic;
+  uint32_t records;
+  uint64_t size;       /* Of the script */
+  int64_t  mtime_sec;
+  int64_t  mtime_nsec;
+  uint64_t hash;       /* Of the contents of the script */
+  uint64_t check;      /* Of the rest of the file */
+} script_header_t;
+
+/**
+ * A line of the script. Records are sorted by offset.
+ */
+typedef struct {
+  uint64_t offset; /* Of the line in the script */
+  uint32_t length;
+  uint32_t kind;   /* script_line_t */
+  uint64_t ir;     /* SCRIPT_TREE: offset of the tree in the file */
+  uint32_t size;   /* SCRIPT_TREE: bytes of the tree */
+  uint32_t unused;
+} script_record_t;
+
+/**
+ * A line recorded by this run, and a copy of its tree.
+ */
+typedef struct {
+  script_record_t record;
+  ir_t *ir;
+} pending_t;
+
+static bool enabled;
+
+/* The script, as mapped by input_open */
+static const char *base;
+static size_t size;
+static script_header_t key;
+
+/* The compiled script, as found, and its records (if it matches) */
+static char *path;
+static char *map;
+static size_t map_size;
+static const script_record_t *records;
+static uint32_t count;
+
+/* Lines recorded since */
+static pending_t *pending;
+static size_t pending_count;
+static size_t pending_size;
+
+
+
+/* Declarations */
+static char    *cache_path   (const char *script);
+static void     load         ();
+static int      by_offset    (const void *key, const void *record);
+static const ir_t *tree_of   (const script_record_t *r);
+static int      write_cache  ();
+static int      write_all    (int fd, const char *buf, size_t length);
+
+
+
+/**
+ * Use the compiled form of the script at path.
+ */
+void script_open(const char *script) {
+  struct stat st;
+
+  base = input_mapping(&size);
+  if (base == NULL || stat(script, &st) != 0) {
+    return;
+  }
+
+  path = cache_path(script);
+  if (path == NULL) {
+    return;
+  }
+
+  memset(&key, 0, sizeof(key));
+  key.magic      = SCRIPT_MAGIC;
+  key.size       = size;
+  key.mtime_sec  = st.st_mtim.tv_sec;
+  key.mtime_nsec = st.st_mtim.tv_nsec;
+  key.hash       = fnv1a(base, size);
+
+  load();
+  enabled = true;
+}
+
+/**
+ * What is known about line.
+ */
+script_line_t script_find(const char *line, size_t length, const ir_t **ir) {
+  if (!enabled || count == 0 || line < base || line >= base + size) {
+    return SCRIPT_UNKNOWN;
+  }
+
+  uint64_t offset = line - base;
+  const script_record_t *r = bsearch(&offset, records, count,
+                                     sizeof(script_record_t), by_offset);
+  if (r == NULL || r->length != length) {
+    return SCRIPT_UNKNOWN;
+  }
+
+  if (r->kind == SCRIPT_TREE) {
+    *ir = tree_of(r);
+    if (*ir == NULL) {
+      /* Damaged: parse the line again, the new record replaces this one */
+      return SCRIPT_UNKNOWN;
+    }
+  }
+
+  return r->kind;
+}
+
+/**
+ * Record what parsing line gave.
+ */
+void script_save(const char *line, size_t length, script_line_t kind,
+    const ir_t *ir) {
+  if (!enabled || line < base || line >= base + size || length > UINT32_MAX) {
+    return;
+  }
+
+  if (pending_count == pending_size) {
+    pending_size = pending_size == 0 ? 64 : 2 * pending_size;
+    pending = realloc(pending, pending_size * sizeof(pending_t));
+    if (pending == NULL) {
+      mfatal(ERR_ALLOCATION);
+    }
+  }
+
+  pending_t *p = &pending[pending_count++];
+  memset(&p->record, 0, sizeof(p->record));
+  p->record.offset = line - base;
+  p->record.length = length;
+  p->record.kind   = kind;
+  p->ir = NULL;
+
+  if (kind == SCRIPT_TREE) {
+    p->ir = malloc(ir->size);
+    if (p->ir == NULL) {
+      mfatal(ERR_ALLOCATION);
+    }
+    memcpy(p->ir, ir, ir->size);
+    p->record.size = ir->size;
+  }
+}
+
+/**
+ * Write the compiled script if lines were recorded, and release it all.
+ */
+void script_close() {
+  size_t i;
+
+  if (!enabled) {
+    return;
+  }
+
+  if (pending_count > 0) {
+    write_cache();
+  }
+
+  for (i = 0; i < pending_count; i++) {
+    free(pending[i].ir);
+  }
+  free(pending);
+  pending = NULL;
+  pending_count = pending_size = 0;
+
+  if (map != NULL) {
+    munmap(map, map_size);
+    map = NULL;
+  }
+  records = NULL;
+  count = 0;
+
+  free(path);
+  path = NULL;
+  enabled = false;
+}
+
+
+
+/**
+ * Where the compiled form of script goes: a file named after the absolute
+ * path of the script in the directory of SCRIPT_CACHE_VAR. NULL when caching
+ * is off (the variable is not set or empty, or names no directory).
+ */
+static char *cache_path(const char *script) {
+  char *dir = getenv(SCRIPT_CACHE_VAR);
+  char *name = NULL;
+
+  if (dir == NULL || *dir == 0) {
+    return NULL;
+  }
+
+  /* Both absolute: the script may change directory before script_close */
+  char *absolute = realpath(script, NULL);
+  char *directory = realpath(dir, NULL);
+  if (absolute != NULL && directory != NULL &&
+      asprintf(&name, "%s/%016llx%s", directory,
+               (unsigned long long)fnv1a(absolute, strlen(absolute)),
+               SCRIPT_CACHE_SUFFIX) < 0) {
+    mfatal(ERR_ALLOCATION);
+  }
+  free(directory);
+  free(absolute);
+
+  return name;
+}
+
+/**
+ * Map the compiled script, and use its records if it was compiled from the
+ * script as it is now.
+ */
+static void load() {
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  struct stat st;
+
+  if (fd < 0) {
+    return;
+  }
+
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) ||
+      (size_t)st.st_size < sizeof(script_header_t)) {
+    close(fd);
+    return;
+  }
+
+  void *m = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (m == MAP_FAILED) {
+    return;
+  }
+
+  map = m;
+  map_size = st.st_size;
+
+  const script_header_t *header = (const script_header_t *)map;
+  if (header->magic != key.magic || header->size != key.size ||
+      header->mtime_sec != key.mtime_sec ||
+      header->mtime_nsec != key.mtime_nsec || header->hash != key.hash) {
+    /* Stale: replaced on close */
+    return;
+  }
+
+  if (header->records > (map_size - sizeof(script_header_t)) /
+                        sizeof(script_record_t) ||
+      header->check != fnv1a(map + sizeof(script_header_t),
+                             map_size - sizeof(script_header_t))) {
+    /* Damaged */
+    return;
+  }
+
+  /* script_find searches them, write_cache merges them: they must be
+   * sorted */
+  const script_record_t *r = (const script_record_t *)(header + 1);
+  uint32_t i;
+  for (i = 1; i < header->records; i++) {
+    if (r[i].offset <= r[i - 1].offset) {
+      return;
+    }
+  }
+
+  records = r;
+  count = header->records;
+}
+
+/**
+ * Compare an offset with the offset of a record.
+ */
+static int by_offset(const void *key, const void *record) {
+  uint64_t offset = *(const uint64_t *)key;
+  uint64_t other = ((const script_record_t *)record)->offset;
+
+  return offset < other ? -1 : offset > other;
+}
+
+/**
+ * The tree of a record, or NULL if the file does not hold a valid one.
+ */
+static const ir_t *tree_of(const script_record_t *r) {
+  if (r->ir % SCRIPT_ALIGN != 0 || r->ir > map_size ||
+      r->size > map_size - r->ir) {
+    return NULL;
+  }
+
+  const ir_t *ir = (const ir_t *)(map + r->ir);
+  return ir_valid(ir, r->size) ? ir : NULL;
+}
+
+/**
+ * Write the records still valid and the new ones, by offset, to a new file
+ * that then replaces the compiled script.
+ */
+static int write_cache() {
+  size_t total = count + pending_count, merged = 0, i = 0, j = 0;
+  script_record_t *out = malloc(total * sizeof(script_record_t));
+  const ir_t **trees = malloc(total * sizeof(ir_t *));
+
+  if (out == NULL || trees == NULL) {
+    mfatal(ERR_ALLOCATION);
+  }
+
+  /* Both lists are sorted; for the same line, the new record wins */
+  while (i < count || j < pending_count) {
+    if (j == pending_count ||
+        (i < count && records[i].offset < pending[j].record.offset)) {
+      const ir_t *ir = NULL;
+      if (records[i].kind != SCRIPT_TREE ||
+          (ir = tree_of(&records[i])) != NULL) {
+        out[merged] = records[i];
+        trees[merged++] = ir;
+      }
+      i++;
+      continue;
+    }
+    if (i < count && records[i].offset == pending[j].record.offset) {
+      i++;
+    }
+    out[merged] = pending[j].record;
+    trees[merged++] = pending[j].ir;
+    j++;
+  }
+
+  /* Lay out the trees after the records */
+  uint64_t at = ALIGN(sizeof(script_header_t) +
+                      merged * sizeof(script_record_t));
+  for (i = 0; i < merged; i++) {
+    out[i].ir = 0;
+    if (trees[i] != NULL) {
+      out[i].ir = at;
+      out[i].size = trees[i]->size;
+      at += ALIGN(trees[i]->size);
+    }
+  }
+
+  char *file = calloc(1, at);
+  if (file == NULL) {
+    mfatal(ERR_ALLOCATION);
+  }
+
+  memcpy(file + sizeof(script_header_t), out,
+         merged * sizeof(script_record_t));
+  for (i = 0; i < merged; i++) {
+    if (trees[i] != NULL) {
+      memcpy(file + out[i].ir, trees[i], trees[i]->size);
+    }
+  }
+
+  script_header_t header = key;
+  header.records = merged;
+  header.check = fnv1a(file + sizeof(script_header_t),
+                       at - sizeof(script_header_t));
+  memcpy(file, &header, sizeof(header));
+
+  /* Replace the file at once, so that no run sees half of it; the new file
+   * gets a name no one else has (the directory may be shared) */
+  char *temp;
+  if (asprintf(&temp, "%s.XXXXXX", path) < 0) {
+    mfatal(ERR_ALLOCATION);
+  }
+
+  int rc = -1;
+  int fd = mkostemp(temp, O_CLOEXEC);
+  if (fd >= 0) {
+    rc = write_all(fd, file, at);
+    if (close(fd) != 0) {
+      rc = -1;
+    }
+    if (rc == 0) {
+      rc = rename(temp, path);
+    }
+    if (rc != 0) {
+      unlink(temp);
+    }
+  }
+
+  free(temp);
+  free(file);
+  free(trees);
+  free(out);
+
+  return rc;
+}
+
+/**
+ * Write length bytes of buf to fd.
+ */
+static int write_all(int fd, const char *buf, size_t length) {
+  while (length > 0) {
+    ssize_t n = write(fd, buf, length);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    buf += n;
+    length -= n;
+  }
+
+  return 0;
+}
@@ -0,0 +1,60 @@
+/******************************************************************************
+ * Mini Shell in Linux - compiled script cache
+ *****************************************************************************/
+
+#ifndef _SCRIPT_H
+#define _SCRIPT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ir.h"
+
+/* Environment variable naming the directory of the compiled scripts; when it
+ * is not set or empty nothing is cached, and nothing is written */
+#define SCRIPT_CACHE_VAR    "MINISHELL_SCRIPT_CACHE"
+#define SCRIPT_CACHE_SUFFIX ".msc"
+
+#define SCRIPT_MAGIC 0x3143534dU /* "MSC1", in the byte order of the machine */
+
+/**
+ * What the compiled script knows about a line.
+ */
+typedef enum {
+  SCRIPT_UNKNOWN, /* Not compiled: parse it */
+  SCRIPT_EMPTY,   /* Nothing to run */
+  SCRIPT_ERROR,   /* Does not parse: parse it to report the error */
+  SCRIPT_TREE     /* Its tree, in compact form */
+} script_line_t;
+
+/**
+ * Use the compiled form of the script at path, mapped in memory by
+ * input_open, when there is one that matches the script (same size,
+ * modification time and hash of its contents) and is intact (its own
+ * checksum), and record the lines parsed
+ * from now on, to be saved by script_close. Does nothing for input that is
+ * not a mapped file or when caching is turned off (see SCRIPT_CACHE_VAR).
+ */
+void script_open(const char *path);
+
+/**
+ * What is known about line (as returned by read_line). For SCRIPT_TREE, *ir
+ * is set to the compact tree of the line, valid until script_close.
+ */
+script_line_t script_find(const char *line, size_t length, const ir_t **ir);
+
+/**
+ * Record what parsing line gave (kind, and ir for SCRIPT_TREE, which is
+ * copied), for a line script_find did not know.
+ */
+void script_save(const char *line, size_t length, script_line_t kind,
+                 const ir_t *ir);
+
+/**
+ * Write the compiled script if lines were recorded (merged with the lines
+ * compiled by earlier runs that are still valid) and release it all. The
+ * file is replaced atomically; failing to write it is not an error.
+ */
+void script_close();
+
+#endif
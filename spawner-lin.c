@@ -0,0 +1,182 @@
+/******************************************************************************
+ * Mini Shell in Linux - spawn engine implementation
+ *****************************************************************************/
+
+#include <errno.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "hash.h"
+#include "here.h"
+#include "minternals.h"
+#include "redirect.h"
+#include "spawner.h"
+#include "utils.h"
+
+extern char **environ;
+
+
+
+/* Declarations */
+static int spawn_pipes    (posix_spawn_file_actions_t *actions,
+                           int in_fd, int out_fd);
+static int spawn_redirects(posix_spawn_file_actions_t *actions,
+                           plan_args_t *args, int *in_fd, int *here_fd);
+static int spawn_input    (posix_spawn_file_actions_t *actions,
+                           const char *path, int *in_fd);
+static int spawn_open     (posix_spawn_file_actions_t *actions, int fd,
+                           const char *path, int flags);
+
+
+
+/**
+ * Start an external command without copying the shell.
+ */
+pid_t spawn_command(plan_args_t *args, int in_fd, int out_fd) {
+  posix_spawn_file_actions_t actions;
+  pid_t pid;
+
+  if (posix_spawn_file_actions_init(&actions) != 0) {
+    return -1;
+  }
+
+  int file_fd = -1, here_fd = -1;
+  int rc = spawn_pipes(&actions, in_fd, out_fd);
+  if (rc == 0) {
+    rc = spawn_redirects(&actions, args, &file_fd, &here_fd);
+  }
+  if (rc == 0) {
+    /* Executable resolved once, not by a walk over PATH at every spawn */
+    const char *path = hash_lookup(args->argv[0]);
+    if (path == NULL) {
+      rc = ENOENT;
+    } else {
+      rc = posix_spawn(&pid, path, &actions, NULL, args->argv, environ);
+    }
+
+    if (rc != 0) {
+      mlog("posix_spawn failed for '%s': %s", args->argv[0], strerror(rc));
+      if (path != NULL && path != args->argv[0] &&
+          (rc == ENOENT || rc == ENOTDIR || rc == EACCES) &&
+          access(path, X_OK) != 0) {
+        /* The executable moved (not a failed redirection): search PATH
+         * again next time */
+        hash_forget(args->argv[0]);
+      }
+    }
+  }
+
+  posix_spawn_file_actions_destroy(&actions);
+  if (file_fd >= 0) {
+    close(file_fd);
+  }
+  if (here_fd >= 0) {
+    close(here_fd);
+  }
+
+  return rc == 0 ? pid : -1;
+}
+
+
+
+/**
+ * Make in_fd and out_fd the standard input and output of the child. Both are
+ * expected to be close-on-exec, so the child does not keep the originals.
+ */
+static int spawn_pipes(posix_spawn_file_actions_t *actions, int in_fd,
+    int out_fd) {
+  int rc = 0;
+
+  if (in_fd >= 0) {
+    rc |= posix_spawn_file_actions_adddup2(actions, in_fd, STDIN_FILENO);
+  }
+  if (out_fd >= 0) {
+    rc |= posix_spawn_file_actions_adddup2(actions, out_fd, STDOUT_FILENO);
+  }
+
+  return rc;
+}
+
+/**
+ * Translate the redirections of a command into file actions, in the same
+ * order redirect_all applies them in the fork path. Targets kept open by
+ * the shell (see redirect_cached) are duplicated rather than opened, and so
+ * is the here-document, written by the shell to *here_fd, and the input
+ * file when it gets hints (see redirect_hints), opened by the shell as
+ * *in_fd; the caller closes both once the child is started. Last, every
+ * other descriptor is closed, in case one is not close-on-exec.
+ */
+static int spawn_redirects(posix_spawn_file_actions_t *actions,
+    plan_args_t *args, int *in_fd, int *here_fd) {
+  int rc = 0;
+
+  if (args->in != NULL) {
+    rc |= spawn_input(actions, args->in, in_fd);
+  }
+
+  if (args->here != NULL) {
+    *here_fd = here_open(args->here, args->here_newline);
+    if (*here_fd < 0) {
+      return -1;
+    }
+    rc |= posix_spawn_file_actions_adddup2(actions, *here_fd, STDIN_FILENO);
+  }
+
+  if (args->out != NULL) {
+    rc |= spawn_open(actions, STDOUT_FILENO, args->out, args->out_flags);
+  }
+
+  if (args->err_to_out) {
+    rc |= posix_spawn_file_actions_adddup2(actions, STDOUT_FILENO,
+                                           STDERR_FILENO);
+  } else if (args->err != NULL) {
+    rc |= spawn_open(actions, STDERR_FILENO, args->err, args->err_flags);
+  }
+
+#if __GLIBC_PREREQ(2, 34)
+  rc |= posix_spawn_file_actions_addclosefrom_np(actions, STDERR_FILENO + 1);
+#endif
+
+  return rc;
+}
+
+/**
+ * Have the child read path as its standard input. With hints for input
+ * files, the shell opens it and gives the hints first; if that fails, so
+ * does the spawn, and the fork path reports the error.
+ */
+static int spawn_input(posix_spawn_file_actions_t *actions,
+    const char *path, int *in_fd) {
+  redirect_hints_t hints;
+  redirect_hints(&hints);
+
+  if (!redirect_hints_input(&hints) || redirect_cached(path, O_RDONLY) >= 0) {
+    return spawn_open(actions, STDIN_FILENO, path, O_RDONLY);
+  }
+
+  *in_fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (*in_fd < 0) {
+    return -1;
+  }
+  redirect_advise_input(*in_fd, &hints);
+
+  return posix_spawn_file_actions_adddup2(actions, *in_fd, STDIN_FILENO);
+}
+
+/**
+ * Have the child open path with flags as descriptor fd.
+ */
+static int spawn_open(posix_spawn_file_actions_t *actions, int fd,
+    const char *path, int flags) {
+  int cached = redirect_cached(path, flags);
+  if (cached >= 0) {
+    return posix_spawn_file_actions_adddup2(actions, cached, fd);
+  }
+
+  return posix_spawn_file_actions_addopen(actions, fd, path, flags, IO_MODE);
+}
@@ -0,0 +1,27 @@
+/******************************************************************************
+ * Mini Shell in Linux - spawn engine
+ *****************************************************************************/
+
+#ifndef _SPAWNER_H
+#define _SPAWNER_H
+
+#include <sys/types.h>
+
+#include "plan.h"
+
+/**
+ * Start an external command without copying the shell (posix_spawn, which
+ * glibc implements with clone(CLONE_VM | CLONE_VFORK)). The arguments and
+ * redirections come from the expanded plan of the command; redirections
+ * are expressed as spawn file actions, applied after in_fd and out_fd (when
+ * not -1) have been made the standard input and output of the child. The
+ * executable is found through hash_lookup rather than a walk over PATH.
+ *
+ * Returns the pid of the child or -1 if the command could not be started
+ * this way (a redirection or the exec itself failed). Nothing is left
+ * running in that case and the caller should fall back to fork, which
+ * reports the error the usual way.
+ */
+pid_t spawn_command(plan_args_t *args, int in_fd, int out_fd);
+
+#endif
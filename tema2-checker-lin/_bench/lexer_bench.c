@@ -0,0 +1,160 @@
+/******************************************************************************
+ * Mini Shell in Linux - lexer microbenchmark
+ *
+ * Scans a generated multi-megabyte command line (long argument lists: paths,
+ * options, a few quoted strings and variables) with the lexer of the parser
+ * and prints its throughput. Built by `make -f Makefile.checker bench-lexer`
+ * once per scanning variant; with FLEX_SCANNER defined it is built against a
+ * tree that still has the flex scanner, for comparison: the baseline, whose
+ * globalParseAnotherString takes a string, or a later one where it also
+ * takes the length of the line, with FLEX_LENGTH defined.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define __PARSER_H_INTERNAL_INCLUDE
+#include "parser.h"
+#include "parser.tab.h"
+
+#define BENCH_MB      8 /* Default size of the line, in megabytes */
+#define BENCH_ROUNDS  5 /* Times the line is scanned */
+
+
+
+/* Declarations */
+static char  *make_line    (size_t size, size_t *length);
+static long   scan_line    (const char *line, size_t length);
+static void   rewind_arena ();
+static double now          ();
+
+
+
+/**
+ * The parser reports errors through this; the benchmark has none.
+ */
+void parse_error(const char *str, const int where) {
+  fprintf(stderr, "Parse error near %d: %s\n", where, str);
+}
+
+/**
+ * lexer_bench LABEL [MEGABYTES]
+ */
+int main(int argc, char **argv) {
+  const char *label = argc > 1 ? argv[1] : "lexer";
+  size_t mb = argc > 2 ? strtoul(argv[2], NULL, 10) : BENCH_MB;
+  size_t length;
+  char *line = make_line(mb << 20, &length);
+  double best = 0;
+  long tokens = 0;
+  int i;
+
+  for (i = 0; i < BENCH_ROUNDS; i++) {
+    double start = now(), elapsed;
+
+    tokens = scan_line(line, length);
+    elapsed = now() - start;
+    if (i == 0 || elapsed < best) {
+      best = elapsed;
+    }
+
+    rewind_arena();
+  }
+
+  printf("   %-20s %8.1f MB/s %10ld tokens %8.2f ms\n", label,
+         length / best / (1 << 20), tokens, best * 1000);
+
+  free(line);
+  return 0;
+}
+
+
+
+/**
+ * A command line of about size bytes.
+ */
+static char *make_line(size_t size, size_t *length) {
+  static const char *words[] = {
+    " --prefix=/usr/local/lib/x86_64-linux-gnu",
+    " -Wl,-rpath,/opt/toolchain/lib64",
+    " src/module_%d/component_%d.c",
+    " \"quoted $HOME text\"",
+    " -O2",
+    " /var/cache/build/objects/%d/%d.o",
+    " $VARIABLE_NAME",
+  };
+  int count = sizeof(words) / sizeof(words[0]);
+  char *line = malloc(size + 128);
+  size_t n = 0;
+  int i = 0;
+
+  if (line == NULL) {
+    perror("malloc");
+    exit(EXIT_FAILURE);
+  }
+
+  n += sprintf(line, "cc");
+  while (n < size) {
+    n += sprintf(line + n, words[i % count], i, i);
+    i++;
+  }
+  n += sprintf(line + n, "\n");
+
+  *length = n;
+  return line;
+}
+
+/**
+ * Scan line up to its end; the number of tokens.
+ */
+static long scan_line(const char *line, size_t length) {
+  long tokens = 0;
+
+#ifdef FLEX_SCANNER
+#ifdef FLEX_LENGTH
+  globalParseAnotherString(line, length);
+#else
+  /* make_line leaves line terminated */
+  globalParseAnotherString(line);
+#endif
+  while (yylex() != END_OF_FILE) {
+    tokens++;
+  }
+  globalEndParsing();
+#else
+  lexer_t lexer;
+  YYSTYPE value;
+  YYLTYPE location;
+
+  lexerStart(&lexer, line, length);
+  while (yylex(&value, &location, &lexer) != END_OF_FILE) {
+    tokens++;
+  }
+#endif
+
+  return tokens;
+}
+
+/**
+ * Give back the memory the strings of the tokens took: parsing a line
+ * starts by rewinding the parse arena (or, in the flex trees, by freeing
+ * what the scanner allocated).
+ */
+static void rewind_arena() {
+  command_t *root = NULL;
+
+  parse_line("\n", &root);
+  free_parse_memory();
+}
+
+/**
+ * Monotonic time, in seconds.
+ */
+static double now() {
+  struct timespec t;
+
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec / 1e9;
+}
@@ -0,0 +1,160 @@
+/******************************************************************************
+ * Mini Shell in Linux - pipe size benchmark
+ *
+ * Runs the pipe chain of test_10 (ls -l | tr | cut | sort | uniq | wc) on a
+ * generated listing of several megabytes, a few times in a row, through
+ * mini-shell with the default pipe size, with the largest one and with pipes
+ * that grow with use (-p auto), and prints the throughput and the context
+ * switches of the shell and its children. Built and run by
+ * `make -f Makefile.checker bench-pipes`.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include <unistd.h>
+
+#define BENCH_MB      32 /* Default size of the listing, in megabytes */
+#define BENCH_RUNS    6  /* Times the chain runs in a script */
+
+#define BENCH_LISTING "_bench/pipe_bench.txt"
+#define BENCH_SCRIPT  "_bench/pipe_bench.sh"
+
+/* The chain of test_10, on the listing instead of ls -l .. */
+#define BENCH_CHAIN "cat " BENCH_LISTING " | tr -s ' ' | cut -d ' ' -f 2 " \
+                    "| sort | uniq | wc -l > /dev/null"
+
+
+
+/* Declarations */
+static size_t make_listing (size_t size);
+static void   make_script  (int runs);
+static void   run_shell    (const char *shell, const char *label,
+                            const char *pipe_size, size_t bytes);
+static double now          ();
+
+
+
+/**
+ * pipe_bench [SHELL] [MEGABYTES] [RUNS]
+ */
+int main(int argc, char **argv) {
+  const char *shell = argc > 1 ? argv[1] : "../mini-shell";
+  size_t mb = argc > 2 ? strtoul(argv[2], NULL, 10) : BENCH_MB;
+  int runs = argc > 3 ? atoi(argv[3]) : BENCH_RUNS;
+
+  size_t bytes = make_listing(mb << 20) * runs;
+  make_script(runs);
+
+  printf("   %-20s %9s %12s %12s %12s\n", "pipes", "time", "throughput",
+         "voluntary", "involuntary");
+  run_shell(shell, "default (64 KB)", NULL, bytes);
+  run_shell(shell, "largest", "1024m", bytes);
+  run_shell(shell, "auto", "auto", bytes);
+
+  unlink(BENCH_SCRIPT);
+  unlink(BENCH_LISTING);
+  return 0;
+}
+
+
+
+/**
+ * A listing like that of ls -l, of about size bytes; its actual size.
+ */
+static size_t make_listing(size_t size) {
+  FILE *f = fopen(BENCH_LISTING, "w");
+  size_t n = 0;
+  int i = 0;
+
+  if (f == NULL) {
+    perror(BENCH_LISTING);
+    exit(EXIT_FAILURE);
+  }
+
+  while (n < size) {
+    n += fprintf(f, "-rw-r--r-- %d user group %8d Apr %2d 12:%02d file_%d.c\n",
+                 1 + i % 7, (i * 7919) % 100000000, 1 + i % 30, i % 60, i);
+    i++;
+  }
+
+  fclose(f);
+  return n;
+}
+
+/**
+ * The script: the chain, runs times.
+ */
+static void make_script(int runs) {
+  FILE *f = fopen(BENCH_SCRIPT, "w");
+  int i;
+
+  if (f == NULL) {
+    perror(BENCH_SCRIPT);
+    exit(EXIT_FAILURE);
+  }
+
+  for (i = 0; i < runs; i++) {
+    fprintf(f, "%s\n", BENCH_CHAIN);
+  }
+  fprintf(f, "exit\n");
+
+  fclose(f);
+}
+
+/**
+ * Run the script through shell, with -p pipe_size unless NULL, and print
+ * the time it took and the context switches of the shell and its children.
+ */
+static void run_shell(const char *shell, const char *label,
+    const char *pipe_size, size_t bytes) {
+  struct rusage usage;
+  int status;
+  double start = now();
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    perror("fork");
+    exit(EXIT_FAILURE);
+  }
+  if (pid == 0) {
+    /* No hints from the environment: only -p changes the pipes; and no
+     * compiled script left behind */
+    unsetenv("MINISHELL_REDIR_HINTS");
+    unsetenv("MINISHELL_SCRIPT_CACHE");
+    if (pipe_size != NULL) {
+      execl(shell, shell, "-p", pipe_size, BENCH_SCRIPT, (char *)NULL);
+    } else {
+      execl(shell, shell, BENCH_SCRIPT, (char *)NULL);
+    }
+    perror(shell);
+    _exit(127);
+  }
+
+  if (wait4(pid, &status, 0, &usage) < 0 || !WIFEXITED(status) ||
+      WEXITSTATUS(status) != 0) {
+    fprintf(stderr, "%s failed\n", shell);
+    exit(EXIT_FAILURE);
+  }
+
+  /* The shell waits for every stage: their usage is part of its own */
+  double elapsed = now() - start;
+  printf("   %-20s %8.3fs %7.1f MB/s %12ld %12ld\n", label, elapsed,
+         bytes / elapsed / (1 << 20), usage.ru_nvcsw, usage.ru_nivcsw);
+}
+
+/**
+ * Monotonic time, in seconds.
+ */
+static double now() {
+  struct timespec t;
+
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec / 1e9;
+}
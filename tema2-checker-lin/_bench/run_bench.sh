@@ -0,0 +1,194 @@
+#!/bin/bash
+
+#
+# Tema2 Benchmarks
+#
+# Every benchmark generates a script, runs it through the reference shell and
+# through mini-shell and prints the wall time of both.
+#
+
+# ----------------- General declarations and util functions ------------------ #
+
+exec_name="mini-shell"
+ref_name="bash"
+
+MAIN_BENCH_DIR="_bench/outputs"
+
+# number of commands for the spawn-rate benchmark
+SPAWN_COUNT=${SPAWN_COUNT:-20000}
+# number and size (in bytes) of lines for the long-line benchmark
+LONG_LINE_COUNT=${LONG_LINE_COUNT:-20}
+LONG_LINE_SIZE=${LONG_LINE_SIZE:-1048576}
+# number of lines for the repeated-lines benchmark
+REPEAT_COUNT=${REPEAT_COUNT:-100000}
+# number of lines and of words per line for the many-tokens benchmark
+TOKEN_LINE_COUNT=${TOKEN_LINE_COUNT:-200}
+TOKEN_LINE_WORDS=${TOKEN_LINE_WORDS:-2000}
+# size (in MB) of the file and number of passes over it for the
+# redirected-streams benchmark, and the hints it tries (see redirect.h)
+STREAM_SIZE=${STREAM_SIZE:-128}
+STREAM_COUNT=${STREAM_COUNT:-8}
+STREAM_HINTS=${STREAM_HINTS:-"sequential,noreuse,pipe=1m"}
+
+# elapsed wall time of a command, in seconds
+elapsed()
+{
+	local start end
+	start=$(date +%s.%N)
+	"$@" &> /dev/null
+	end=$(date +%s.%N)
+	awk -v s=$start -v e=$end 'BEGIN { printf "%.3f", e - s }'
+}
+
+# prints a result line: name, time and number of commands per second
+print_result()
+{
+	awk -v n="$1" -v t=$2 -v c=$3 \
+		'BEGIN { printf "   %-20s %8.3fs %12.0f cmd/s\n", n, t, c / t }'
+}
+
+# prints a throughput line: name, time and megabytes per second
+print_throughput()
+{
+	awk -v n="$1" -v t=$2 -v m=$3 \
+		'BEGIN { printf "   %-20s %8.3fs %12.1f MB/s\n", n, t, m / t }'
+}
+
+# runs a generated script through both shells, on the standard input, and
+# through mini-shell in batch mode: once compiling the script (into
+# MAIN_BENCH_DIR) and once more running the compiled form
+run_script()
+{
+	local script=$1 count=$2 name
+
+	for name in $ref_name ./$exec_name; do
+		print_result "$(basename $name)" \
+			$(elapsed $name < "$script") $count
+	done
+	rm -f $MAIN_BENCH_DIR/*.msc
+	print_result "$exec_name (batch)" \
+		$(MINISHELL_SCRIPT_CACHE=$MAIN_BENCH_DIR \
+		  elapsed ./$exec_name "$script") $count
+	print_result "$exec_name (cached)" \
+		$(MINISHELL_SCRIPT_CACHE=$MAIN_BENCH_DIR \
+		  elapsed ./$exec_name "$script") $count
+}
+
+# ---------------------------------------------------------------------------- #
+
+# ----------------- Benchmarks ----------------------------------------------- #
+
+# many short external commands, nothing else
+bench_spawn_rate()
+{
+	local script=$MAIN_BENCH_DIR/spawn_rate.sh i
+
+	for ((i = 0; i < $SPAWN_COUNT; i++)); do
+		echo "/bin/true $i"
+	done > $script
+	echo "exit" >> $script
+
+	run_script $script $SPAWN_COUNT
+}
+
+# very long command lines (variable assignments, so nothing is executed)
+bench_long_lines()
+{
+	local script=$MAIN_BENCH_DIR/long_lines.sh
+	local value i
+
+	value=$(head -c $LONG_LINE_SIZE /dev/zero | tr '\0' 'x')
+	for ((i = 0; i < $LONG_LINE_COUNT; i++)); do
+		echo "LONG_LINE_$i=$value"
+	done > $script
+	echo "exit" >> $script
+
+	run_script $script $LONG_LINE_COUNT
+}
+
+# the same few command lines over and over (assignments, nothing is executed)
+bench_repeated_lines()
+{
+	local script=$MAIN_BENCH_DIR/repeated_lines.sh i
+
+	for ((i = 0; i < $REPEAT_COUNT; i += 4)); do
+		echo 'A=some_value; B=another_value ; C=$A$B'
+		echo 'D="quoted $A value" ; E=$D'
+		echo "F='single quoted'"
+		echo 'G=/usr/bin:/bin:$HOME/bin'
+	done > $script
+	echo "exit" >> $script
+
+	run_script $script $REPEAT_COUNT
+}
+
+# long command lines made of many short words, quoted strings and variables
+# (given to the true builtin, so nothing is started); the lines differ, so
+# that each one is parsed
+bench_many_tokens()
+{
+	local script=$MAIN_BENCH_DIR/many_tokens.sh
+	local words i
+
+	words=$(for ((i = 0; i < $TOKEN_LINE_WORDS; i += 4)); do
+		printf 'arg_%d "quoted $HOME %d" '"'single'"' a=b%d ' $i $i $i
+	done)
+	for ((i = 0; i < $TOKEN_LINE_COUNT; i++)); do
+		echo "true $i $words"
+	done > $script
+	echo "exit" >> $script
+
+	run_script $script $TOKEN_LINE_COUNT
+}
+
+# a large file read through an input redirection and through a pipe, with
+# and without the redirection hints
+bench_redirected_streams()
+{
+	local script=$MAIN_BENCH_DIR/redirected_streams.sh
+	local file=$MAIN_BENCH_DIR/stream.dat
+	local bytes=$((STREAM_SIZE * 1024 * 1024)) i
+
+	head -c $bytes /dev/urandom > $file
+	for ((i = 0; i < $STREAM_COUNT; i++)); do
+		echo "wc -l < $file"
+		echo "head -c $bytes $file | wc -l"
+	done > $script
+	echo "exit" >> $script
+
+	print_throughput "$ref_name" \
+		$(elapsed $ref_name "$script") $((2 * STREAM_SIZE * STREAM_COUNT))
+	print_throughput "$exec_name" \
+		$(MINISHELL_REDIR_HINTS= elapsed ./$exec_name "$script") \
+		$((2 * STREAM_SIZE * STREAM_COUNT))
+	print_throughput "$exec_name (hints)" \
+		$(MINISHELL_REDIR_HINTS=$STREAM_HINTS elapsed ./$exec_name "$script") \
+		$((2 * STREAM_SIZE * STREAM_COUNT))
+}
+
+bench_fun_array=(						\
+	bench_spawn_rate	"Spawn rate (external commands)"	\
+	bench_long_lines	"Long command lines (1 MB)"		\
+	bench_repeated_lines	"Repeated command lines"		\
+	bench_many_tokens	"Command lines with many tokens"	\
+	bench_redirected_streams "Redirected streams"		\
+)
+
+# ---------------------------------------------------------------------------- #
+
+# ----------------- Run benchmarks ------------------------------------------- #
+
+if ! [ -e "$exec_name" ]; then
+	echo "$exec_name not found! Cannot run the benchmarks"
+	exit 1
+fi
+
+rm -rf $MAIN_BENCH_DIR
+mkdir -p $MAIN_BENCH_DIR
+
+for ((i = 0; i < ${#bench_fun_array[@]}; i += 2)); do
+	printf "%02d) %s\n" $((i / 2 + 1)) "${bench_fun_array[$((i + 1))]}"
+	${bench_fun_array[$i]}
+done
+
+rm -rf $MAIN_BENCH_DIR
@@ -15,7 +15,7 @@ MAIN_TEST_DIR="_test/outputs"
 INPUT_DIR="_test/inputs"
 REFS_DIR="_test/refs"
 LOG_FILE="/dev/null"
-max_points=90
+max_points=112
 TEST_TIMEOUT=30
 
 TEST_LIB=_test/test_lib.sh
@@ -111,6 +111,7 @@ execute_cmd()
 	[ -z "$OUTPUT" ] && OUTPUT=$LOG_FILE
 	mkdir -p ${OUT_DIR} && cd ${OUT_DIR} &> $LOG_FILE
 	timeout $TEST_TIMEOUT $EXEC < "${INPUT}" &> $OUTPUT
+	EXEC_STATUS=$?
 	# Ocasionally, in a virtualized environment, the diff that compares the
 	# target implementation with the reference output starts before the
 	# target implementation has finished writing files to disk. Handle this
@@ -162,6 +163,69 @@ test_common()
 	cleanup_test
 }
 
+# tests exit codes: as test_common, also comparing those of the shells
+test_exit_status()
+{
+	init_test
+
+	# commands to execute the test
+	execute_cmd $ref_name "../${IN_FILE}"
+	echo $EXEC_STATUS > ${OUT_DIR}/shell_status.txt
+	# move OUT_DIR in order to preserve the pwd output
+	mv ${OUT_DIR} ${REF_DIR}
+	execute_cmd $exec_name "../${IN_FILE}"
+	echo $EXEC_STATUS > ${OUT_DIR}/shell_status.txt
+
+	# test output
+	basic_test diff -r -ui ${REF_DIR} ${OUT_DIR}
+
+	cleanup_test
+}
+
+# runs every command line of shell_runs (mini-shell with some options or
+# environment) on the input, comparing each run with the one of bash
+test_runs()
+{
+	init_test
+
+	# commands to execute the test
+	execute_cmd $ref_name "../${IN_FILE}"
+	# move OUT_DIR in order to preserve the pwd output
+	mv ${OUT_DIR} ${REF_DIR}
+
+	# test output
+	basic_test compare_runs
+
+	cleanup_test
+}
+
+# used by test_runs
+compare_runs()
+{
+	local run
+
+	for run in "${shell_runs[@]}"; do
+		execute_cmd "$run" "../${IN_FILE}"
+		diff -r -ui ${REF_DIR} ${OUT_DIR} || return 1
+		rm -rf ${OUT_DIR}
+	done
+}
+
+# runs the branches of parallel chains one at a time
+test_jobs()
+{
+	shell_runs=("$exec_name -j 1" "env MINISHELL_JOBS=1 $exec_name")
+	test_runs
+}
+
+# runs pipe chains with pipes of other sizes
+test_pipe_size()
+{
+	shell_runs=("$exec_name -p 1m" "$exec_name -p auto" \
+		"env MINISHELL_REDIR_HINTS=pipe=4k $exec_name")
+	test_runs
+}
+
 # test 18 - tests environment variables
 test_exec_failed()
 {
@@ -196,6 +260,14 @@ test_fun_array=(								\
 	test_common		"Testing sleep command"			7	\
 	test_common		"Testing fscanf function"		7	\
 	test_exec_failed	"Testing unknown command"		4	\
+	test_common		"Testing pass-through cat stages"	2	\
+	test_common		"Testing echo escapes and cd"		3	\
+	test_jobs		"Testing parallel branches one at a time"	2	\
+	test_exit_status	"Testing exit codes"			3	\
+	test_common		"Testing conditional parallel branches"	3	\
+	test_common		"Testing redirect to /dev/stdout"	2	\
+	test_common		"Testing here-documents and here-strings"	5	\
+	test_pipe_size		"Testing pipe sizes"			2	\
 )
 
 
@@ -7,7 +7,7 @@
 #
 
 first_test=1
-last_test=18
+last_test=26
 script=./_test/run_test.sh
 
 # Call init to set up testing environment
@@ -30,7 +30,7 @@ BEGIN {
 }
 
 END {
-    printf "\n%66s  [%02d/90]\n", "Total:", sum;
+    printf "\n%66s  [%02d/112]\n", "Total:", sum;
 }'
 
 # Cleanup testing environment
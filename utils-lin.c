@@ -6,6 +6,7 @@
  *****************************************************************************/
 
 #include <assert.h>
+#include <errno.h>
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -18,86 +19,93 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#include "builtins.h"
+#include "chain.h"
+#include "hash.h"
 #include "minternals.h"
+#include "parallel.h"
+#include "pipeline.h"
+#include "plan.h"
+#include "reaper.h"
+#include "redirect.h"
+#include "spawner.h"
 #include "utils.h"
 
+/**
+ * A branch of a parallel chain, while it runs.
+ */
+typedef struct {
+  command_t *c;
+  chain_t *chain;  /* Conditional chain run by the shell itself, or NULL */
+  int leaf;        /* Leaf of the chain that runs now */
+  int *pids;       /* Children of the command that runs now */
+  int count;
+  int left;        /* Children still running */
+  int code;        /* Exit code of the command, once over */
+  long switches;   /* Most voluntary context switches of one of them */
+} branch_t;
 
 
-/* Declarations */
-static int  shell_exit ();
-static bool shell_cd   (word_t *dir);
 
-static int  do_simple     (simple_command_t *s, int level, 
-                           command_t *father);
-static int  do_in_parallel(command_t *cmd1, command_t *cmd2, int level, 
-                           command_t *father);
-static bool do_on_pipe    (command_t *cmd1, command_t *cmd2, int level,
-                           command_t *father);
+int last_status;
+
 
-static void redirect_all (simple_command_t *s);
-static void redirect_in  (simple_command_t *s);
-static void redirect_out (simple_command_t *s);
-static void redirect_err (simple_command_t *s);
 
-static char  *get_word (word_t *s);
-static char **get_argv (simple_command_t *command, int *size);
+/* Declarations */
+static int  run_command   (command_t *c, int level);
+static int  do_simple     (simple_command_t *s, int level, 
+                           command_t *father);
+static bool is_assignment (simple_command_t *s);
+static int  start_command (plan_args_t *args, int in_fd, int out_fd);
+static int  fork_command  (plan_args_t *args, int in_fd, int out_fd);
+static int  start_stage   (command_t *c, int in_fd, int out_fd, int level);
+static int  do_in_parallel(command_t *c, int level, command_t *father);
+static int  do_on_pipe    (command_t *c, int level, command_t *father);
+static int *start_pipeline(command_t *c, int level, int *count);
+static int  wait_children (int *pids, int count, long *switches);
+static bool start_branch  (branch_t *b, int level, bool alone);
+static bool next_leaf     (branch_t *b);
+static bool find_child    (branch_t *branches, int n, int pid, int *branch,
+                           int *stage);
+static int  exit_code     (int status);
+static void exit_subshell (int rc);
+static int  run_builtin   (builtin_t builtin, plan_args_t *args);
 
 
 
 /**
- * Readline from mini-shell.
+ * Parse and execute a command.
  */
-char *read_line() {
-  char *instr;
-  char *chunk;
-  char *ret;
-
-  int instr_length;
-  int chunk_length;
-
-  int endline = 0;
-
-  instr = NULL;
-  instr_length = 0;
+int parse_command(command_t *c, int level, command_t *father) {
+  int rc = run_command(c, level);
 
-  chunk = calloc(CHUNK_SIZE, sizeof(char));
-  if (chunk == NULL) {
-    fprintf(stderr, ERR_ALLOCATION);
-    return instr;
+  if (rc != SHELL_EXIT) {
+    last_status = rc;
   }
+  return rc;
+}
 
-  while (!endline) {
-    ret = fgets(chunk, CHUNK_SIZE, stdin);
-    if (ret == NULL) {
-      break;
-    }
-
-    chunk_length = strlen(chunk);
-    if (chunk[chunk_length - 1] == '\n') {
-      chunk[chunk_length - 1] = 0;
-      endline = 1;
-    }
+/**
+ * Get the variable name.
+ */
+const char *get_variable(const char *name) {
+  static char status[16];
 
-    ret = instr;
-    instr = realloc(instr, instr_length + CHUNK_SIZE + 1);
-    if (instr == NULL) {
-      free(ret);
-      return instr;
-    }
-    memset(instr + instr_length, 0, CHUNK_SIZE);
-    strcat(instr, chunk);
-    instr_length += chunk_length;
+  if (strcmp(name, "?") == 0) {
+    snprintf(status, sizeof(status), "%d", last_status);
+    return status;
   }
 
-  free(chunk);
-
-  return instr;
+  const char *value = getenv(name);
+  return value != NULL ? value : "";
 }
 
+
+
 /**
- * Parse and execute a command.
+ * Execute the command c, for parse_command.
  */
-int parse_command(command_t *c, int level, command_t *father) {
+static int run_command(command_t *c, int level) {
   if (c == NULL) {
     mfatal("c is NULL");
   }
@@ -116,7 +124,7 @@ int parse_command(command_t *c, int level, command_t *father) {
       return rc;
     } case OP_PARALLEL: {
       /* Execute the commands simultaneously */
-      int rc = do_in_parallel(c->cmd1, c->cmd2, level+1, c);
+      int rc = do_in_parallel(c, level+1, c);
       return rc;
     } case OP_CONDITIONAL_NZERO: {
       int rc = parse_command(c->cmd1, level+1, c);
@@ -131,9 +139,8 @@ int parse_command(command_t *c, int level, command_t *father) {
       }
       return rc;
     } case OP_PIPE: {
-      /* TODO redirect the output of the first command to the
-       * input of the second */
-      int rc = do_on_pipe(c->cmd1, c->cmd2, level+1, c);
+      /* Execute the whole pipe chain at once */
+      int rc = do_on_pipe(c, level+1, c);
       return rc;
     } default: {
       assert(false);
@@ -145,27 +152,6 @@ int parse_command(command_t *c, int level, command_t *father) {
 
 
 
-/**
- * Internal exit/quit command.
- */
-static int shell_exit() {
-  return SHELL_EXIT;
-}
-
-/**
- * Internal change-directory command.
- */
-static bool shell_cd(word_t *dir) {
-  char *dir_name = get_word(dir);
-  int rc = chdir(dir_name);
-  free(dir_name);
-  if (rc != 0) {
-    perror("Could not change directory");
-    exit(EXIT_FAILURE);
-  }
-  return rc;
-}
-
 /**
  * Execute a simple command (internal, environment variable assignment,
  * external command).
@@ -182,38 +168,10 @@ static int do_simple(simple_command_t *s, int level, command_t *father) {
     mfatal("cmd2 not NULL");
   }
 
-  /* If builtin command, execute the command */
-  char *word = get_word(s->verb);
-  if (strcmp(word, "exit") == 0 || strcmp(word, "quit") == 0) {
-    free(word);
-    return shell_exit();
-  }
-
-  if (strcmp(word, "cd") == 0) {
-    /* Save context */
-    int stdin_copy  = dup(0);
-    int stdout_copy = dup(1);
-    int stderr_copy = dup(2);
-
-    redirect_all(s);
-    int rc = shell_cd(s->params);
-
-    /* Restore context */
-    dup2(stdin_copy,  0);
-    dup2(stdout_copy, 1);
-    dup2(stderr_copy, 2);
-    close(stdin_copy);
-    close(stdout_copy);
-    close(stderr_copy);
-
-    free(word);
-    return rc;
-  }
-
   /* If variable assignment, execute the assignment */
-  word_t *next_part = s->verb->next_part;
-  if (next_part != NULL && strcmp(next_part->string, "=") == 0) {
+  if (is_assignment(s)) {
     /* Add or overwrite if exists */
+    word_t *next_part = s->verb->next_part;
     char *value = get_word(next_part->next_part);
     int rc = setenv(s->verb->string, value, 1);
     if (rc < 0) {
@@ -221,330 +179,458 @@ static int do_simple(simple_command_t *s, int level, command_t *father) {
        exit(EXIT_FAILURE);
     }
 
+    if (strcmp(s->verb->string, "PATH") == 0) {
+      /* Commands may now resolve to other executables */
+      hash_clear();
+    }
+
     free(value);
-    free(word);
+    return rc;
+  }
+
+  plan_args_t args;
+  plan_expand(plan_get(s), &args);
+
+  /* If builtin command, execute it inside the shell */
+  builtin_t builtin = builtin_lookup(args.argv[0]);
+  if (builtin != NULL) {
+    int rc = run_builtin(builtin, &args);
+    plan_release(&args);
     return rc;
   }
 
   /* External command */
-  int pid = fork();
-  switch(pid) {
-    case -1: { /* Fork error */
-      perror("Could not fork");
-      free(word);
-      exit(EXIT_FAILURE);
-    } case 0: { /* Child */
-      char *cmd = get_word(s->verb);
-      int size;
-      char **argv = get_argv(s, &size);
+  int pid = start_command(&args, -1, -1);
+  plan_release(&args);
+
+  /* Wait for child */
+  return exit_code(reaper_wait(pid, NULL));
+}
 
-      redirect_all(s);
+/**
+ * Check whether s is an environment variable assignment (name=value).
+ */
+static bool is_assignment(simple_command_t *s) {
+  word_t *next_part = s->verb->next_part;
 
-      execvp(cmd, (char *const *)argv);
+  return next_part != NULL && next_part->expand == false &&
+         strcmp(next_part->string, "=") == 0;
+}
 
-      fprintf(stderr, "Execution failed for '%s'\n", cmd);
-      exit(EXIT_FAILURE);
-    } default: { /* Parent */
-      break;
-    }
+/**
+ * Execute an internal command with its redirections, then give the shell
+ * back its standard input, output and error.
+ */
+static int run_builtin(builtin_t builtin, plan_args_t *args) {
+  redirect_frame_t frame;
+
+  int rc = EXIT_FAILURE;
+  if (redirect_push(&frame, args) == 0) {
+    rc = builtin(args->argv);
   }
+  redirect_pop(&frame);
 
-  /* Wait for child */
-  int status;
-  waitpid(pid, &status, 0);
+  return rc;
+}
 
-  free(word);
-  return status;
+/**
+ * Start an external command with in_fd and out_fd (when not -1) as its
+ * standard input and output. Returns the pid of the child.
+ */
+static int start_command(plan_args_t *args, int in_fd, int out_fd) {
+  /* Fast path: no copy of the shell; fork only to report failures */
+  int pid = spawn_command(args, in_fd, out_fd);
+  if (pid < 0) {
+    pid = fork_command(args, in_fd, out_fd);
+  } else {
+    reaper_add(pid);
+  }
+
+  return pid;
 }
 
 /**
- * Process two commands in parallel, by creating two children.
+ * Fork the shell and execute an external command in the child. This is the
+ * slow path, taken when spawn_command could not start the command.
  */
-static int do_in_parallel(command_t *cmd1, command_t *cmd2, int level,
-    command_t *father) {
-  /* First command */
-  int pid1 = fork();
-  switch(pid1) {
+static int fork_command(plan_args_t *args, int in_fd, int out_fd) {
+  int pid = reaper_fork();
+  switch(pid) {
     case -1: { /* Fork error */
       perror("Could not fork");
       exit(EXIT_FAILURE);
     } case 0: { /* Child */
-      int rc = parse_command(cmd1, level + 1, father);
-      exit(rc);
-    } default: { /* Parent */
-      break;
-    }
-  }
+      if (in_fd >= 0) {
+        dup2(in_fd, STDIN_FILENO);
+      }
+      if (out_fd >= 0) {
+        dup2(out_fd, STDOUT_FILENO);
+      }
+      if (redirect_all(args) != 0) {
+        exit(EXIT_FAILURE);
+      }
+      redirect_close_others();
 
-  /* Second command */
-  int pid2 = fork();
-  switch(pid2) {
-    case -1: {/* Fork error */
-      perror("Could not fork");
-      exit(EXIT_FAILURE);
-    } case 0: { /* Child */
-      int rc = parse_command(cmd2, level + 1, father);
+      execvp(args->argv[0], args->argv);
+
+      int rc = errno == ENOENT ? EXIT_NOT_FOUND : EXIT_NOT_EXECUTABLE;
+      fprintf(stderr, "Execution failed for '%s'\n", args->argv[0]);
       exit(rc);
     } default: { /* Parent */
       break;
     }
   }
 
-  /* Wait for childs */
-  int status1, status2;
-  waitpid(pid1, &status1, 0);
-  waitpid(pid2, &status2, 0);
-
-  return status2;
+  return pid;
 }
 
 /**
- * Run commands by creating an anonymous pipe (cmd1 | cmd2)
+ * Start one stage of a pipeline or one branch of a parallel chain. External
+ * commands are started directly; anything else runs in a copy of the shell,
+ * as it would in any subshell.
  */
-static bool do_on_pipe(command_t *cmd1, command_t *cmd2, int level,
-    command_t *father) {
-  /* Create pipe */
-  int fd[2];
-  if (pipe(fd) != 0) {
-    fprintf(stderr, "error pipe\n");
-    exit(EXIT_FAILURE);
-  }
-
-  /* First command */
-  int pid1 = fork();
-  switch(pid1) {
-    case -1: { /* Fork error */
-      perror("Could not fork");
-      exit(EXIT_FAILURE);
-    } case 0: { /* Child */
-      close(fd[0]);         /* Close unused read end */
-      close(STDOUT_FILENO); /* Close stdout */
-      dup(fd[1]);           /* Set write end of pipe as stdout */
+static int start_stage(command_t *c, int in_fd, int out_fd, int level) {
+  if (c->op == OP_NONE && !is_assignment(c->scmd)) {
+    plan_args_t args;
+    plan_expand(plan_get(c->scmd), &args);
+
+    int pid = -1;
+    if (builtin_lookup(args.argv[0]) == NULL) {
+      pid = start_command(&args, in_fd, out_fd);
+    }
+    plan_release(&args);
 
-      int rc = parse_command(cmd1, level+1, father);
-      exit(rc);
-    } default: { /* Parent */
-      break;
+    if (pid >= 0) {
+      return pid;
     }
   }
 
-  int pid2 = fork();
-  switch(pid2) {
+  int pid = reaper_fork();
+  switch(pid) {
     case -1: { /* Fork error */
       perror("Could not fork");
       exit(EXIT_FAILURE);
     } case 0: { /* Child */
-      close(fd[1]);        /* Close unused write end */
-      close(STDIN_FILENO); /* Close stdin */
-      dup(fd[0]);          /* Set read end of pipe as stdin */
+      if (in_fd >= 0) {
+        dup2(in_fd, STDIN_FILENO);
+      }
+      if (out_fd >= 0) {
+        dup2(out_fd, STDOUT_FILENO);
+      }
 
-      int rc = parse_command(cmd2, level+1, father);
-      exit(rc);
+      exit_subshell(parse_command(c, level + 1, c->up));
     } default: { /* Parent */
       break;
     }
   }
 
-  close(fd[0]); /* Close unused read end */
-  close(fd[1]); /* Close unused write end */
-
-  /* Wait for childs */
-  int status1, status2;
-  waitpid(pid1, &status1, 0);
-  waitpid(pid2, &status2, 0);
-
-  return status2;
+  return pid;
 }
 
 /**
- * Redirect input, output and error of s
+ * Run the branches of a parallel chain at the same time, at most
+ * parallel_jobs() of them at once; the others are started, in order, as
+ * running ones end. The whole chain is run by this shell: simple commands
+ * and pipe chains are started directly, conditional chains are driven leaf
+ * by leaf as their commands end (see chain_get), and only the remaining
+ * branches get a subshell each. The status is that of the last branch.
  */
-static void redirect_all(simple_command_t *s) {
-  redirect_in(s);
-  redirect_out(s);
-  redirect_err(s);  
-}
+static int do_in_parallel(command_t *c, int level, command_t *father) {
+  parallel_t p;
+  parallel_collect(c, &p);
 
-/**
- * Redirect input of s
- */
-static void redirect_in(simple_command_t *s) {
-  if (s->in != NULL) {
-    char *filename = get_word(s->in);
-    int in_fd = open(filename, O_RDONLY);
-    free(filename);
-    if (in_fd < 0) {
-      perror("Could not open input file");
-      exit(EXIT_FAILURE);
+  branch_t *branches = calloc(p.count, sizeof(branch_t));
+  if (branches == NULL) {
+    mfatal(ERR_ALLOCATION);
+  }
+
+  int jobs = parallel_jobs();
+  int next = 0;     /* First branch in the run queue */
+  int running = 0;  /* Branches started and not over */
+
+  while (next < p.count || running > 0) {
+    if (next < p.count && running < jobs) {
+      branch_t *b = &branches[next];
+      b->c = p.branches[next];
+      b->chain = chain_get(b->c);
+      if (start_branch(b, level, running == 0 && next == p.count - 1)) {
+        running++;
+      }
+      next++;
+      continue;
     }
 
-    int rc = dup2(in_fd, STDIN_FILENO);
-    if (rc < 0) {
-      perror("Could not duplicate STDIN_FILENO");
-      exit(EXIT_FAILURE);
+    /* All slots taken: wait for any child of the chain */
+    int child_status;
+    struct rusage usage;
+    int pid = reaper_wait_any(&child_status, &usage);
+    if (pid < 0) {
+      break;
     }
-  }
-}
 
-/**
- * Redirect output of s
- */
-static void redirect_out(simple_command_t *s) {
-  if (s->out != NULL) {
-    int out_fd;
-    char *filename = get_word(s->out);
-    if (s->io_flags == IO_REGULAR) {
-      out_fd = open(filename, O_WRONLY | O_TRUNC  | O_CREAT, IO_MODE);
-      free(filename);
-    } else if (s->io_flags == IO_OUT_APPEND) {
-      out_fd = open(filename, O_WRONLY | O_APPEND | O_CREAT, IO_MODE);
-      free(filename);
-    } else {
-      free(filename);
-      mfatal("out io_flags = %d", s->io_flags);
+    int i, j;
+    if (!find_child(branches, next, pid, &i, &j)) {
+      continue;
     }
 
-    if (out_fd < 0) {
-      perror("Could not open output file");
-      exit(EXIT_FAILURE);
+    branch_t *b = &branches[i];
+    if (j == b->count - 1) {
+      /* The last stage gives the exit code */
+      b->code = exit_code(child_status);
+    }
+    if (usage.ru_nvcsw > b->switches) {
+      b->switches = usage.ru_nvcsw;
+    }
+    if (--b->left > 0) {
+      continue;
     }
 
-    int rc = dup2(out_fd, STDOUT_FILENO);
-    if (rc < 0) {
-      perror("Could not duplicate STDOUT_FILENO");
-      exit(EXIT_FAILURE);
+    command_t *done = b->chain != NULL ? b->chain->leaves[b->leaf] : b->c;
+    if (done->op == OP_PIPE) {
+      pipeline_observe(done, b->switches);
+    }
+    free(b->pids);
+    b->pids = NULL;
+    b->count = 0;
+    b->switches = 0;
+
+    /* The command of the branch is over: go on with its chain, if any */
+    if (b->chain != NULL && next_leaf(b) &&
+        start_branch(b, level, running == 1 && next == p.count)) {
+      continue;
     }
+    running--;
   }
+
+  int status = branches[p.count - 1].code;
+
+  free(branches);
+  parallel_free(&p);
+
+  return status;
 }
 
 /**
- * Redirect error of s
+ * Start the command of the branch b: the branch itself, or the current leaf
+ * of its chain. When b is alone (no other branch running or left to start),
+ * leaves that are internal commands run right away, in the shell; otherwise
+ * they get a child like any other command, so that one writing to a slow
+ * pipe or FIFO does not hold up the other branches. Returns false if b is
+ * over without any child left running.
  */
-static void redirect_err(simple_command_t *s) {
-  if (s->err != NULL) {
-    int err_fd;
-    char *filename_err = get_word(s->err);
-    if (s->io_flags == IO_REGULAR) {
-      char *filename_out = get_word(s->out);
-      if (s->out != NULL && strcmp(filename_err, filename_out) == 0) {
-        err_fd = STDOUT_FILENO;
-      } else {
-        err_fd = open(filename_err, O_WRONLY | O_TRUNC | O_CREAT, IO_MODE);
+static bool start_branch(branch_t *b, int level, bool alone) {
+  while (true) {
+    command_t *c = b->chain != NULL ? b->chain->leaves[b->leaf] : b->c;
+
+    if (alone && b->chain != NULL && c->op == OP_NONE &&
+        builtin_lookup(c->scmd->verb->string) != NULL) {
+      b->code = parse_command(c, level, c->up);
+      if (!next_leaf(b)) {
+        return false;
       }
-      free(filename_err);
-      free(filename_out);
-    } else if (s->io_flags == IO_ERR_APPEND) {
-      err_fd = open(filename_err, O_WRONLY | O_APPEND | O_CREAT, IO_MODE);
-      free(filename_err);
-    } else {
-      free(filename_err);
-      mfatal("Unrecognized io_flags: %d", s->io_flags);
+      continue;
     }
 
-    if (err_fd < 0) {
-      perror("Could not open error file");
-      exit(EXIT_FAILURE);
+    if (c->op == OP_PIPE) {
+      b->pids = start_pipeline(c, level, &b->count);
+    } else {
+      b->pids = malloc(sizeof(int));
+      if (b->pids == NULL) {
+        mfatal(ERR_ALLOCATION);
+      }
+      b->pids[0] = start_stage(c, -1, -1, level);
+      b->count = 1;
     }
 
-    int rc = dup2(err_fd, STDERR_FILENO);
-    if (rc < 0) {
-      perror("Could not duplicate STDERR_FILENO");
-      exit(EXIT_FAILURE);
+    b->left = b->count;
+    return true;
+  }
+}
+
+/**
+ * Move the chain of b to the leaf that follows the one that just ended with
+ * b->code. Returns false if the chain is over.
+ */
+static bool next_leaf(branch_t *b) {
+  /* As in a subshell running the chain, $? is the code of that leaf */
+  last_status = b->code;
+
+  if (b->code == 0) {
+    b->leaf = b->chain->on_zero[b->leaf];
+  } else {
+    b->leaf = b->chain->on_nonzero[b->leaf];
+  }
+
+  return b->leaf < b->chain->count;
+}
+
+/**
+ * Find pid among the children of the first n branches. Returns false if it
+ * is not there.
+ */
+static bool find_child(branch_t *branches, int n, int pid, int *branch,
+    int *stage) {
+  int i, j;
+
+  for (i = 0; i < n; i++) {
+    for (j = 0; j < branches[i].count; j++) {
+      if (branches[i].pids[j] == pid) {
+        *branch = i;
+        *stage = j;
+        return true;
+      }
     }
   }
+
+  return false;
 }
 
 /**
- * Concatenate parts of the word to obtain the command
+ * Execute a chain of pipes: every stage is started by this shell.
  */
-static char *get_word(word_t *s) {
-  int string_length = 0;
-  int substring_length = 0;
+static int do_on_pipe(command_t *c, int level, command_t *father) {
+  int count;
+  int *pids = start_pipeline(c, level, &count);
 
-  char *string = NULL;
-  char *substring = NULL;
+  long switches;
+  int rc = wait_children(pids, count, &switches);
+  pipeline_observe(c, switches);
 
-  while (s != NULL) {
-    substring = strdup(s->string);
+  return rc;
+}
 
-    if (substring == NULL) {
-      return NULL;
-    }
+/**
+ * Start every stage of the pipe chain rooted at c, connected by anonymous
+ * pipes. Returns the pids of the stages (count of them), left to right.
+ */
+static int *start_pipeline(command_t *c, int level, int *count) {
+  pipeline_t p;
+  pipeline_collect(c, &p);
+  pipeline_optimize(&p);
+
+  int *pids = calloc(p.count, sizeof(int));
+  if (pids == NULL) {
+    mfatal(ERR_ALLOCATION);
+  }
 
-    if (s->expand == true) {
-      char *aux = substring;
-      substring = getenv(substring);
-
-      /* prevents strlen from failing */
-      if (substring == NULL) {
-        substring = calloc(1, sizeof(char));
-        if (substring == NULL) {
-          free(aux);
-          return NULL;
-        }
+  int size = pipeline_pipe_size(c);
+
+  int in_fd = p.in_fd; /* Read end of the previous pipe */
+  int i;
+  for (i = 0; i < p.count; i++) {
+    /* Pipes are close-on-exec: each child keeps only its own ends */
+    int fd[2] = { -1, -1 };
+    if (i < p.count - 1) {
+      if (pipe2(fd, O_CLOEXEC) != 0) {
+        fprintf(stderr, "error pipe\n");
+        exit(EXIT_FAILURE);
+      }
+      if (size > 0) {
+        /* Not fatal: the pipe keeps its default size */
+        fcntl(fd[1], F_SETPIPE_SZ, size);
       }
-
-      free(aux);
     }
 
-    substring_length = strlen(substring);
+    pids[i] = start_stage(p.stages[i], in_fd, fd[1], level);
 
-    string = realloc(string, string_length + substring_length + 1);
-    if (string == NULL) {
-      if (substring != NULL)
-        free(substring);
-      return NULL;
+    if (in_fd >= 0 && in_fd != p.in_fd) {
+      close(in_fd);
     }
+    if (fd[1] >= 0) {
+      close(fd[1]);
+    }
+    in_fd = fd[0];
+  }
 
-    memset(string + string_length, 0, substring_length + 1);
+  *count = p.count;
+  pipeline_free(&p);
 
-    strcat(string, substring);
-    string_length += substring_length;
+  return pids;
+}
 
-    if (s->expand == false) {
-      free(substring);
+/**
+ * Wait for the children in pids and release the array. The exit code is that
+ * of the last one; switches is set to the most voluntary context switches
+ * one of them made.
+ */
+static int wait_children(int *pids, int count, long *switches) {
+  struct rusage usage;
+  int status = 0;
+  int i;
+
+  *switches = 0;
+  for (i = 0; i < count; i++) {
+    memset(&usage, 0, sizeof(usage));
+    status = reaper_wait(pids[i], &usage);
+    if (usage.ru_nvcsw > *switches) {
+      *switches = usage.ru_nvcsw;
     }
-
-    s = s->next_part;
   }
+  free(pids);
 
-  return string;
+  return exit_code(status);
 }
 
 /**
- * Concatenate command arguments in a NULL terminated list in order to pass
- * them directly to execv.
+ * Exit code of a child from its wait status: the code it exited with, or
+ * 128 plus the signal that killed it.
  */
-static char **get_argv(simple_command_t *command, int *size) {
-  char **argv;
-  word_t *param;
-
-  int argc = 0;
-  argv = calloc(argc + 1, sizeof(char *));
-  assert(argv != NULL);
+static int exit_code(int status) {
+  if (WIFSIGNALED(status)) {
+    return 128 + WTERMSIG(status);
+  }
+  return WEXITSTATUS(status);
+}
 
-  argv[argc] = get_word(command->verb);
-  assert(argv[argc] != NULL);
+/**
+ * End a subshell after it ran a command that returned rc. exit in a
+ * subshell only ends the subshell.
+ */
+static void exit_subshell(int rc) {
+  exit(rc == SHELL_EXIT ? last_status : rc);
+}
 
-  argc++;
+/**
+ * Concatenate parts of the word to obtain the command
+ */
+char *get_word(word_t *s) {
+  size_t length = 0;
+  word_t *part;
 
-  param = command->params;
-  while (param != NULL) {
-    argv = realloc(argv, (argc + 1) * sizeof(char *));
-    assert(argv != NULL);
+  for (part = s; part != NULL; part = part->next_part) {
+    length += strlen(part->expand ? get_variable(part->string) : part->string);
+  }
 
-    argv[argc] = get_word(param);
-    assert(argv[argc] != NULL);
+  char *string = malloc(length + 1);
+  if (string == NULL) {
+    return NULL;
+  }
 
-    param = param->next_word;
-    argc++;
+  char *to = string;
+  for (part = s; part != NULL; part = part->next_part) {
+    const char *value = part->expand ? get_variable(part->string)
+                                     : part->string;
+    size_t value_length = strlen(value);
+    memcpy(to, value, value_length);
+    to += value_length;
   }
+  *to = 0;
 
-  argv = realloc(argv, (argc + 1) * sizeof(char *));
-  assert(argv != NULL);
+  return string;
+}
 
-  argv[argc] = NULL;
-  *size = argc;
+/**
+ * FNV-1a hash of length bytes
+ */
+uint64_t fnv1a(const void *bytes, size_t length) {
+  const unsigned char *b = bytes;
+  uint64_t hash = 14695981039346656037ULL;
+  size_t i;
+
+  for (i = 0; i < length; i++) {
+    hash ^= b[i];
+    hash *= 1099511628211ULL;
+  }
 
-  return argv;
+  return hash;
 }
@@ -8,23 +8,48 @@
 #ifndef _UTILS_H
 #define _UTILS_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include "parser.h"
 
-#define CHUNK_SIZE 100
 #define ERR_ALLOCATION "unable to allocate memory"
 
 #define SHELL_EXIT -100
 
 #define IO_MODE 0664
 
+/* Exit codes of commands that could not be executed, as in bash */
+#define EXIT_NOT_FOUND      127
+#define EXIT_NOT_EXECUTABLE 126
+
 /**
- * Readline from mini-shell.
+ * Exit code of the last command that ran (the special parameter ?). It is
+ * also the exit code of the shell.
  */
-char *read_line();
+extern int last_status;
 
 /**
- * Parse and execute a command.
+ * Parse and execute a command. Returns its exit code (0 - 255, or 128 plus
+ * the signal that killed it), or SHELL_EXIT.
  */
 int parse_command(command_t *, int, command_t *);
 
+/**
+ * Value of the variable name: the special parameter ? or an environment
+ * variable ("" when not set). The value of ? stays valid until the next
+ * command ends.
+ */
+const char *get_variable(const char *name);
+
+/**
+ * Concatenate parts of the word to obtain the command.
+ */
+char *get_word(word_t *s);
+
+/**
+ * FNV-1a hash of length bytes.
+ */
+uint64_t fnv1a(const void *bytes, size_t length);
+
 #endif